@@ -0,0 +1,73 @@
+/*
+ * @file benchmarks/bench-alloc.c Heap allocation counter
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+#include <stdlib.h>
+
+#include "bench-alloc.h"
+
+/*
+ * Counts calls to malloc(), calloc() and realloc() in the whole process,
+ * GLib and GTK included, by defining them in the program and forwarding
+ * to the C library. This needs glibc, elsewhere the count stays 0.
+ */
+
+static volatile gint n_allocs = 0;
+
+#ifdef __GLIBC__
+extern void *__libc_malloc (size_t size);
+extern void *__libc_calloc (size_t n_members, size_t size);
+extern void *__libc_realloc (void *ptr, size_t size);
+
+void *
+malloc (size_t size)
+{
+	g_atomic_int_inc (&n_allocs);
+	return __libc_malloc (size);
+}
+
+void *
+calloc (size_t n_members, size_t size)
+{
+	g_atomic_int_inc (&n_allocs);
+	return __libc_calloc (n_members, size);
+}
+
+void *
+realloc (void *ptr, size_t size)
+{
+	g_atomic_int_inc (&n_allocs);
+	return __libc_realloc (ptr, size);
+}
+#endif
+
+gboolean
+bench_alloc_supported (void)
+{
+#ifdef __GLIBC__
+	return TRUE;
+#else
+	return FALSE;
+#endif
+}
+
+guint
+bench_alloc_count (void)
+{
+	return (guint) g_atomic_int_get (&n_allocs);
+}
@@ -0,0 +1,84 @@
+/*
+ * @file benchmarks/bench-backend.c Checkers for the benchmarks
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+#include <stdlib.h>
+
+#include "sexy-wordlist-backend.h"
+#include "bench-backend.h"
+
+/*
+ * The numbers of a benchmark depend on which dictionaries happen to be
+ * installed, unless it checks against a fixed word list. That is done
+ * when SEXY_BENCH_WORDLIST names a file with one word per line, which
+ * is then loaded as the language of the benchmark.
+ *
+ * SEXY_BENCH_CHECK_LATENCY and SEXY_BENCH_SUGGEST_LATENCY add that many
+ * microseconds to every lookup and suggestion, to model a slow provider.
+ */
+
+static guint
+getenv_uint (const gchar *name)
+{
+	const gchar *value = g_getenv (name);
+
+	return value ? (guint) strtoul (value, NULL, 10) : 0;
+}
+
+/**
+ * bench_checker_new:
+ * @lang: The language to activate.
+ * @error: Return location for an error, or %NULL.
+ *
+ * Returns: (transfer full) (nullable): a checker with @lang active, or
+ *          %NULL if it is not available.
+ */
+SexySpellChecker *
+bench_checker_new (const gchar *lang, GError **error)
+{
+	const gchar *path = g_getenv ("SEXY_BENCH_WORDLIST");
+	SexySpellChecker *checker;
+
+	if (path != NULL)
+	{
+		SexyWordlistBackend *backend = sexy_wordlist_backend_new ();
+
+		sexy_wordlist_backend_set_check_latency (backend, getenv_uint ("SEXY_BENCH_CHECK_LATENCY"));
+		sexy_wordlist_backend_set_suggest_latency (backend, getenv_uint ("SEXY_BENCH_SUGGEST_LATENCY"));
+		if (!sexy_wordlist_backend_load_file (backend, lang, path, error))
+		{
+			g_object_unref (backend);
+			return NULL;
+		}
+
+		checker = sexy_spell_checker_new_with_backend (SEXY_SPELL_BACKEND(backend));
+		g_object_unref (backend);
+	}
+	else
+	{
+		checker = sexy_spell_checker_new ();
+	}
+
+	if (!sexy_spell_checker_activate_language (checker, lang, error))
+	{
+		g_object_unref (checker);
+		return NULL;
+	}
+
+	return checker;
+}
@@ -0,0 +1,129 @@
+/*
+ * @file benchmarks/bench-batch.c Batch checking throughput
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+/*
+ * Checks a batch of short messages with 1, 2, 4, ... threads up to one
+ * per processor and reports the messages per second of each, and the
+ * speedup over a single thread. Every round is run once untimed first,
+ * so the threads have loaded their copies of the dictionary.
+ *
+ * Usage: bench-batch [LANGUAGE] [MESSAGES]
+ *
+ * See bench-backend.c for checking against a fixed word list.
+ */
+
+#include <stdlib.h>
+
+#include "sexy-spell-checker.h"
+#include "bench-backend.h"
+
+static const gchar *sentences[] = {
+	"The quick brown fox jumps over the lazy dog",
+	"but teh lazy dgo does not notice",
+	"Spelling mistakes like recieve and seperate are common",
+	"see https://example.com/docs or ~/notes/todo.txt",
+	"meeting moved to thursday, bring the acommodation forms",
+	"I definately think we should ship it tomorow",
+	"the build of 3f2a9c1 passed on every platform",
+	"thanks for the quick review!",
+};
+
+#define MIN_TIME G_USEC_PER_SEC
+
+static gdouble
+messages_per_second (SexySpellChecker *checker, const gchar * const *texts, guint n_texts)
+{
+	gint64 start, elapsed;
+	guint64 n_checked = 0;
+
+	g_ptr_array_unref (sexy_spell_checker_check_batch (checker, texts, n_texts, NULL, NULL));
+
+	start = g_get_monotonic_time ();
+	do
+	{
+		g_ptr_array_unref (sexy_spell_checker_check_batch (checker, texts, n_texts, NULL, NULL));
+		n_checked += n_texts;
+		elapsed = g_get_monotonic_time () - start;
+	}
+	while (elapsed < MIN_TIME);
+
+	return (gdouble) n_checked * G_USEC_PER_SEC / elapsed;
+}
+
+int
+main (int argc, char **argv)
+{
+	const gchar *lang = argc > 1 ? argv[1] : "en_US";
+	guint n_texts = argc > 2 ? (guint) atoi (argv[2]) : 20000;
+	guint n_cores = g_get_num_processors ();
+	SexySpellChecker *checker;
+	GPtrArray *texts;
+	GRand *rand;
+	gdouble single = 0;
+	guint n_threads, i, j;
+	GError *error = NULL;
+
+	checker = bench_checker_new (lang, &error);
+	if (checker == NULL)
+	{
+		g_printerr ("bench-batch: %s, skipped\n", error->message);
+		g_error_free (error);
+		return 77;
+	}
+
+	/* Messages of one to four sentences, so the chunks are uneven */
+	rand = g_rand_new_with_seed (42);
+	texts = g_ptr_array_new_with_free_func (g_free);
+	for (i = 0; i < n_texts; i++)
+	{
+		GString *text = g_string_new (NULL);
+		guint n = g_rand_int_range (rand, 1, 5);
+
+		for (j = 0; j < n; j++)
+		{
+			g_string_append (text, sentences[g_rand_int_range (rand, 0, G_N_ELEMENTS (sentences))]);
+			g_string_append (text, ". ");
+		}
+		g_ptr_array_add (texts, g_string_free (text, FALSE));
+	}
+	g_rand_free (rand);
+
+	g_print ("language:              %s\n", lang);
+	g_print ("messages:              %u\n", n_texts);
+
+	for (n_threads = 1; ; n_threads = MIN(n_threads * 2, n_cores))
+	{
+		gdouble rate;
+
+		sexy_spell_checker_set_batch_threads (checker, n_threads);
+		rate = messages_per_second (checker, (const gchar * const *) texts->pdata, n_texts);
+		if (n_threads == 1)
+			single = rate;
+
+		g_print ("  %2u threads:          %.0f messages/s (%.2fx)\n", n_threads, rate, rate / single);
+
+		if (n_threads == n_cores)
+			break;
+	}
+
+	g_ptr_array_unref (texts);
+	g_object_unref (checker);
+
+	return 0;
+}
@@ -0,0 +1,34 @@
+#!/bin/sh
+#
+# Compares two reports of bench-micro case by case, for example one of
+# the last release and one of the working tree:
+#
+#   ./bench-micro > new.tsv
+#   ./bench-compare.sh old.tsv new.tsv
+#
+# Changes in time of more than 5% are marked with a + or a -.
+
+if test $# -ne 2; then
+	echo "Usage: $0 OLD NEW" >&2
+	exit 2
+fi
+
+awk -F '\t' '
+/^#/ || $1 == "case" { next }
+FNR == NR { ns[$1] = $3; allocs[$1] = $4; rss[$1] = $5; next }
+BEGIN {
+	printf "%-22s %12s %12s %8s  %17s  %17s\n", "case", "old ns/word", "new ns/word", "change",
+	       "allocs/word", "peak RSS (kB)"
+}
+{
+	if (!($1 in ns)) {
+		printf "%-22s %12s %12.1f %8s  %17s  %17s\n", $1, "-", $3, "new", "- -> " $4, "- -> " $5
+		next
+	}
+
+	change = ns[$1] > 0 ? ($3 - ns[$1]) * 100 / ns[$1] : 0
+	mark = change > 5 ? "+" : change < -5 ? "-" : " "
+	printf "%-22s %12.1f %12.1f %+7.1f%%%s %17s  %17s\n", $1, ns[$1], $3, change, mark,
+	       allocs[$1] " -> " $4, rss[$1] " -> " $5
+}
+' "$1" "$2"
@@ -0,0 +1,125 @@
+/*
+ * @file benchmarks/bench-corpus.c Fixed texts for the benchmarks
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+#include "bench-corpus.h"
+
+/*
+ * Two texts that are the same on every run and every machine, so the
+ * numbers of two revisions can be compared.
+ *
+ * The synthetic text is made of words built from syllables with a fixed
+ * seed. Most of them are not in any dictionary, so it stresses lookups
+ * and underlines. Every tenth token is a number, a URL or a path, which
+ * the skip rules have to deal with.
+ *
+ * The natural text is English prose with a few common misspellings,
+ * punctuation, contractions and accented words, repeated as needed.
+ */
+
+#define SEED 42
+
+static const gchar *syllables[] = {
+	"ka", "ri", "mo", "ten", "sa", "lu", "vor", "en", "di", "pa",
+	"the", "ing", "ar", "qu", "est", "ol", "ne", "zu", "ho", "ber",
+};
+
+static const gchar *others[] = {
+	"2024", "3.14", "v1.2.0", "https://example.com/a/b", "~/src/main.c",
+	"user@example.org", "0x1f", "42nd", "#123", "@someone",
+};
+
+static const gchar prose[] =
+	"Spell checking is one of those features that people only notice when "
+	"it gets in the way. A good checker underlines the mistakes as you type, "
+	"without making the cursor lag or the window stutter, and it doesn't "
+	"complain about names, numbers or addresses like https://example.com. "
+	"Most of the time the text is short: a search query, a subject line or "
+	"a chat message. Sometimes, though, somebody pastes a whole paragraph "
+	"from an email, and the entry has to recieve it without freezing. The "
+	"naïve approach checks every word again after each keystroke, which is "
+	"fine for ten words and definately not for ten thousand. Caching the "
+	"verdicts helps, as does only looking at the words that changed. The "
+	"résumé of the café owner mentions the façade, the rôle and the "
+	"crème brûlée, which are seperate words in most dictionaries. It's "
+	"worth measuring all of this on real text, because the occurence of "
+	"short, common words is much higher than in any generated list. ";
+
+const gchar *
+bench_corpus_get_name (BenchCorpus corpus)
+{
+	switch (corpus)
+	{
+		case BENCH_CORPUS_SYNTHETIC:
+			return "synthetic";
+		case BENCH_CORPUS_NATURAL:
+			return "natural";
+	}
+
+	g_return_val_if_reached (NULL);
+}
+
+static void
+append_synthetic (GString *text, GRand *rand)
+{
+	guint n, i;
+
+	if (g_rand_int_range (rand, 0, 10) == 0)
+	{
+		g_string_append (text, others[g_rand_int_range (rand, 0, G_N_ELEMENTS (others))]);
+	}
+	else
+	{
+		n = g_rand_int_range (rand, 1, 5);
+		for (i = 0; i < n; i++)
+			g_string_append (text, syllables[g_rand_int_range (rand, 0, G_N_ELEMENTS (syllables))]);
+	}
+
+	g_string_append (text, g_rand_int_range (rand, 0, 12) == 0 ? ". " : " ");
+}
+
+/**
+ * bench_corpus_generate:
+ * @corpus: Which text to generate.
+ * @size: The length in bytes.
+ *
+ * Returns: (transfer full): @size bytes of the text, cut at a character
+ *          boundary, to be freed with g_free().
+ */
+gchar *
+bench_corpus_generate (BenchCorpus corpus, gsize size)
+{
+	GString *text = g_string_sized_new (size + sizeof (prose));
+	GRand *rand = g_rand_new_with_seed (SEED);
+	const gchar *end;
+
+	while (text->len < size)
+	{
+		if (corpus == BENCH_CORPUS_SYNTHETIC)
+			append_synthetic (text, rand);
+		else
+			g_string_append (text, prose);
+	}
+	g_rand_free (rand);
+
+	/* Don't cut a character in half */
+	g_utf8_validate (text->str, size, &end);
+	g_string_truncate (text, end - text->str);
+
+	return g_string_free (text, FALSE);
+}
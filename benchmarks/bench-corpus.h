@@ -0,0 +1,35 @@
+/*
+ * @file benchmarks/bench-corpus.h Fixed texts for the benchmarks
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef enum
+{
+	BENCH_CORPUS_SYNTHETIC,
+	BENCH_CORPUS_NATURAL
+} BenchCorpus;
+
+const gchar *bench_corpus_get_name (BenchCorpus corpus);
+gchar *bench_corpus_generate (BenchCorpus corpus, gsize size);
+
+G_END_DECLS
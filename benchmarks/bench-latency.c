@@ -0,0 +1,583 @@
+/*
+ * @file benchmarks/bench-latency.c Input to paint latency of the entry
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+/*
+ * Shows a window with a few SexySpellEntries and replays scripted
+ * sessions on them, one event at a time at a fixed rate:
+ *
+ *   typing    typing sentences, fixing a few mistakes with backspace
+ *   paste     pasting paragraphs with Ctrl+V
+ *   preedit   composing accented letters with dead keys
+ *   menu      opening the context menu on a misspelled word
+ *
+ * Key events go through GTK as if they came from the display, so the
+ * input method, the key bindings and every handler of the entry run as
+ * usual. An event counts as painted at the first frame painted after
+ * its effect: a change of the text or the preedit, or the first draw of
+ * the menu. The window keeps its frame clock running, and frames that
+ * come later than one refresh interval after the previous one are
+ * counted as dropped.
+ *
+ * Prints one tab-separated line per session with the percentiles of
+ * the input to paint latency and of the time spent in the handlers,
+ * the events that never had an effect, and the frames painted and
+ * dropped. Needs a display, see bench-latency.sh for running it on
+ * Xvfb or Broadway.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <string.h>
+
+#include <gtk/gtk.h>
+
+#include "sexy-spell-entry.h"
+#include "bench-backend.h"
+#include "bench-corpus.h"
+
+#define SETTLE_MSEC 300
+#define PREFILL_SIZE 512
+#define PASTE_SIZE 2048
+#define N_PASTES 20
+#define N_MENUS 10
+#define N_PREEDIT_ROUNDS 3
+#define DEFAULT_REFRESH_INTERVAL 16667
+
+typedef struct _Harness Harness;
+
+/* Sends the event for @step, returns FALSE once the script is done */
+typedef gboolean (*StepFunc) (Harness *h, guint step);
+
+typedef struct
+{
+	const gchar *name;
+	StepFunc step;
+} Script;
+
+typedef struct
+{
+	gint64 input;
+	gboolean seen;
+} Pending;
+
+struct _Harness
+{
+	GtkWidget *window;
+	GPtrArray *entries;
+	guint current;
+	gchar *prefill;
+	gchar *paste;
+	GtkWidget *menu;
+	GMainLoop *loop;
+
+	const Script *script;
+	guint step;
+
+	/* Events waiting for a paint */
+	GArray *pending;
+	GArray *latencies;
+	GArray *handling;
+
+	gboolean measuring;
+	gint64 last_frame;
+	guint n_frames;
+	guint n_dropped;
+};
+
+static gint n_entries = 4;
+static gint rate = 20;
+static gchar *lang = NULL;
+static gchar **sessions = NULL;
+
+static GOptionEntry options[] = {
+	{ "entries", 'n', 0, G_OPTION_ARG_INT, &n_entries, "Type into N entries in turn (4)", "N" },
+	{ "rate", 'r', 0, G_OPTION_ARG_INT, &rate, "Send N events per second (20)", "N" },
+	{ "language", 'l', 0, G_OPTION_ARG_STRING, &lang, "Check with LANG (en_US)", "LANG" },
+	{ "session", 's', 0, G_OPTION_ARG_STRING_ARRAY, &sessions,
+	  "Only run SESSION: typing, paste, preedit or menu, may be repeated", "SESSION" },
+	{ NULL }
+};
+
+static const gchar typing_text[] =
+	"The quick brown fox jumps over teh\b\b\bthe lazy dog. Spelling mistakes "
+	"like recieve\b\b\b\beive and seperate are common. Most of the time the "
+	"text is short, a subject line or a chat mesage\b\bsage. It's worth "
+	"measuring on real text, because short words are common.";
+
+/* Dead keys compose the accented letters, with a preedit in between */
+static const guint preedit_keys[] = {
+	GDK_KEY_c, GDK_KEY_a, GDK_KEY_f, GDK_KEY_dead_acute, GDK_KEY_e, GDK_KEY_space,
+	GDK_KEY_n, GDK_KEY_a, GDK_KEY_dead_diaeresis, GDK_KEY_i, GDK_KEY_v, GDK_KEY_e, GDK_KEY_space,
+	GDK_KEY_f, GDK_KEY_a, GDK_KEY_dead_cedilla, GDK_KEY_c, GDK_KEY_a, GDK_KEY_d, GDK_KEY_e, GDK_KEY_space,
+	GDK_KEY_r, GDK_KEY_dead_circumflex, GDK_KEY_o, GDK_KEY_l, GDK_KEY_e, GDK_KEY_space,
+	GDK_KEY_m, GDK_KEY_a, GDK_KEY_dead_tilde, GDK_KEY_n, GDK_KEY_a, GDK_KEY_n, GDK_KEY_a,
+	GDK_KEY_period, GDK_KEY_space,
+};
+
+static void
+switch_entry (Harness *h)
+{
+	GtkWidget *entry;
+
+	h->current = (h->current + 1) % h->entries->len;
+	entry = g_ptr_array_index (h->entries, h->current);
+	gtk_widget_grab_focus (entry);
+	gtk_editable_set_position (GTK_EDITABLE(entry), -1);
+}
+
+/* Records the latency of the events whose effect was seen */
+static void
+resolve_pending (Harness *h, gint64 now)
+{
+	guint i = 0;
+
+	while (i < h->pending->len)
+	{
+		Pending *pending = &g_array_index (h->pending, Pending, i);
+		gint64 latency = now - pending->input;
+
+		if (!pending->seen)
+		{
+			i++;
+			continue;
+		}
+
+		g_array_append_val (h->latencies, latency);
+		g_array_remove_index (h->pending, i);
+	}
+}
+
+static void
+mark_seen (Harness *h)
+{
+	guint i;
+
+	for (i = 0; i < h->pending->len; i++)
+		g_array_index (h->pending, Pending, i).seen = TRUE;
+}
+
+static void
+send_key (Harness *h, guint keyval, GdkModifierType state)
+{
+	GdkDisplay *display = gtk_widget_get_display (h->window);
+	Pending pending = { 0, };
+	GdkKeymapKey *keys;
+	GdkEvent *event;
+	gint64 handling;
+	gint n_keys;
+
+	event = gdk_event_new (GDK_KEY_PRESS);
+	event->key.window = g_object_ref (gtk_widget_get_window (h->window));
+	event->key.time = GDK_CURRENT_TIME;
+	event->key.keyval = keyval;
+	event->key.state = state;
+
+	/* Key bindings are matched on the hardware keycode */
+	if (gdk_keymap_get_entries_for_keyval (gdk_keymap_get_for_display (display), keyval, &keys, &n_keys))
+	{
+		event->key.hardware_keycode = keys[0].keycode;
+		event->key.group = keys[0].group;
+		g_free (keys);
+	}
+	gdk_event_set_device (event, gdk_seat_get_keyboard (gdk_display_get_default_seat (display)));
+
+	pending.input = g_get_monotonic_time ();
+	g_array_append_val (h->pending, pending);
+
+	gtk_main_do_event (event);
+	event->key.type = GDK_KEY_RELEASE;
+	gtk_main_do_event (event);
+
+	handling = g_get_monotonic_time () - pending.input;
+	g_array_append_val (h->handling, handling);
+
+	gdk_event_free (event);
+}
+
+static gboolean
+typing_step (Harness *h, guint step)
+{
+	gchar c;
+
+	if (step >= strlen (typing_text))
+		return FALSE;
+
+	c = typing_text[step];
+	if (c == '\b')
+		send_key (h, GDK_KEY_BackSpace, 0);
+	else
+		send_key (h, gdk_unicode_to_keyval (c), 0);
+
+	/* Every sentence goes to the next entry */
+	if (c == '.')
+		switch_entry (h);
+
+	return TRUE;
+}
+
+static gboolean
+paste_step (Harness *h, guint step)
+{
+	GtkClipboard *clipboard;
+
+	if (step >= N_PASTES)
+		return FALSE;
+
+	if (step == 0)
+	{
+		clipboard = gtk_clipboard_get_for_display (gtk_widget_get_display (h->window), GDK_SELECTION_CLIPBOARD);
+		gtk_clipboard_set_text (clipboard, h->paste, -1);
+	}
+
+	send_key (h, GDK_KEY_v, GDK_CONTROL_MASK);
+	switch_entry (h);
+
+	return TRUE;
+}
+
+static gboolean
+preedit_step (Harness *h, guint step)
+{
+	if (step >= G_N_ELEMENTS (preedit_keys) * N_PREEDIT_ROUNDS)
+		return FALSE;
+
+	send_key (h, preedit_keys[step % G_N_ELEMENTS (preedit_keys)], 0);
+
+	return TRUE;
+}
+
+static gboolean
+close_menu (gpointer data)
+{
+	Harness *h = data;
+
+	if (h->menu != NULL)
+		gtk_menu_shell_deactivate (GTK_MENU_SHELL(h->menu));
+
+	return G_SOURCE_REMOVE;
+}
+
+static gboolean
+menu_drawn (GtkWidget *menu, cairo_t *cr, gpointer data)
+{
+	Harness *h = data;
+
+	/* The menu is painted in a window of its own */
+	mark_seen (h);
+	resolve_pending (h, g_get_monotonic_time ());
+
+	g_signal_handlers_disconnect_by_func (menu, menu_drawn, data);
+	g_idle_add (close_menu, h);
+
+	return FALSE;
+}
+
+static void
+populate_popup (GtkEntry *entry, GtkWidget *menu, gpointer data)
+{
+	Harness *h = data;
+
+	if (h->menu != NULL)
+		g_object_remove_weak_pointer (G_OBJECT(h->menu), (gpointer *) &h->menu);
+
+	h->menu = menu;
+	g_object_add_weak_pointer (G_OBJECT(menu), (gpointer *) &h->menu);
+	g_signal_connect_after (menu, "draw", G_CALLBACK(menu_drawn), h);
+}
+
+static gboolean
+menu_step (Harness *h, guint step)
+{
+	GtkWidget *entry;
+	SexySpellChecker *checker;
+	const gchar *text;
+	GArray *spans;
+
+	if (step >= N_MENUS)
+		return FALSE;
+
+	switch_entry (h);
+	entry = g_ptr_array_index (h->entries, h->current);
+	checker = sexy_spell_entry_get_checker (SEXY_SPELL_ENTRY(entry));
+	text = gtk_entry_get_text (GTK_ENTRY(entry));
+
+	/* The keyboard opens the menu on the word at the cursor */
+	spans = sexy_spell_checker_check_text (checker, text, -1);
+	if (spans->len > 0)
+	{
+		SexySpellSpan *span = &g_array_index (spans, SexySpellSpan, step % spans->len);
+
+		gtk_editable_set_position (GTK_EDITABLE(entry), g_utf8_pointer_to_offset (text, text + span->start) + 1);
+	}
+	g_array_unref (spans);
+
+	send_key (h, GDK_KEY_Menu, 0);
+
+	return TRUE;
+}
+
+static const Script scripts[] = {
+	{ "typing", typing_step },
+	{ "paste", paste_step },
+	{ "preedit", preedit_step },
+	{ "menu", menu_step },
+};
+
+static void
+entry_changed (GtkWidget *entry, gpointer data)
+{
+	mark_seen (data);
+}
+
+static void
+entry_preedit_changed (GtkWidget *entry, const gchar *preedit, gpointer data)
+{
+	mark_seen (data);
+}
+
+static void
+after_paint (GdkFrameClock *clock, gpointer data)
+{
+	resolve_pending (data, g_get_monotonic_time ());
+}
+
+static gboolean
+tick (GtkWidget *widget, GdkFrameClock *clock, gpointer data)
+{
+	Harness *h = data;
+	gint64 frame_time = gdk_frame_clock_get_frame_time (clock);
+	gint64 interval = 0;
+
+	if (h->measuring && h->last_frame != 0)
+	{
+		gdk_frame_clock_get_refresh_info (clock, frame_time, &interval, NULL);
+		if (interval <= 0)
+			interval = DEFAULT_REFRESH_INTERVAL;
+
+		/* Two intervals since the last frame means one was missed */
+		h->n_dropped += MAX((frame_time - h->last_frame + interval / 2) / interval - 1, 0);
+		h->n_frames++;
+	}
+	h->last_frame = frame_time;
+
+	/* Keep the clock running, so late frames show */
+	return G_SOURCE_CONTINUE;
+}
+
+static gboolean
+quit_loop (gpointer data)
+{
+	Harness *h = data;
+
+	g_main_loop_quit (h->loop);
+	return G_SOURCE_REMOVE;
+}
+
+static void
+wait_for (Harness *h, guint msec)
+{
+	g_timeout_add (msec, quit_loop, h);
+	g_main_loop_run (h->loop);
+}
+
+static gboolean
+run_step (gpointer data)
+{
+	Harness *h = data;
+
+	if (h->script->step (h, h->step++))
+		return G_SOURCE_CONTINUE;
+
+	/* Let the last events get painted */
+	g_timeout_add (SETTLE_MSEC, quit_loop, h);
+	return G_SOURCE_REMOVE;
+}
+
+static gint
+compare_int64 (gconstpointer a, gconstpointer b)
+{
+	gint64 x = *(const gint64 *) a, y = *(const gint64 *) b;
+
+	return x < y ? -1 : x > y;
+}
+
+static gint64
+percentile (GArray *sorted, gdouble p)
+{
+	if (sorted->len == 0)
+		return 0;
+
+	return g_array_index (sorted, gint64, MIN((guint) (p * sorted->len), sorted->len - 1));
+}
+
+static void
+run_session (Harness *h, const Script *script)
+{
+	guint i;
+
+	/* Start from the same text every time */
+	for (i = 0; i < h->entries->len; i++)
+		gtk_entry_set_text (GTK_ENTRY(g_ptr_array_index (h->entries, i)), h->prefill);
+	h->current = h->entries->len - 1;
+	switch_entry (h);
+	wait_for (h, SETTLE_MSEC);
+
+	g_array_set_size (h->pending, 0);
+	g_array_set_size (h->latencies, 0);
+	g_array_set_size (h->handling, 0);
+	h->n_frames = 0;
+	h->n_dropped = 0;
+	h->last_frame = 0;
+	h->measuring = TRUE;
+
+	h->script = script;
+	h->step = 0;
+	g_timeout_add (1000 / rate, run_step, h);
+	g_main_loop_run (h->loop);
+
+	h->measuring = FALSE;
+	close_menu (h);
+
+	g_array_sort (h->latencies, compare_int64);
+	g_array_sort (h->handling, compare_int64);
+
+	g_print ("%s\t%u\t%" G_GINT64_FORMAT "\t%" G_GINT64_FORMAT "\t%" G_GINT64_FORMAT "\t%" G_GINT64_FORMAT
+	         "\t%" G_GINT64_FORMAT "\t%" G_GINT64_FORMAT "\t%u\t%u\t%u\n",
+	         script->name, h->handling->len,
+	         percentile (h->latencies, 0.5), percentile (h->latencies, 0.9),
+	         percentile (h->latencies, 0.99), percentile (h->latencies, 1),
+	         percentile (h->handling, 0.5), percentile (h->handling, 0.99),
+	         h->pending->len, h->n_frames, h->n_dropped);
+}
+
+static gboolean
+is_selected (const Script *script)
+{
+	guint i;
+
+	if (sessions == NULL)
+		return TRUE;
+
+	for (i = 0; sessions[i]; i++)
+	{
+		if (g_strcmp0 (sessions[i], script->name) == 0)
+			return TRUE;
+	}
+	return FALSE;
+}
+
+int
+main (int argc, char **argv)
+{
+	GOptionContext *context;
+	SexySpellChecker *checker;
+	Harness h = { 0, };
+	GtkWidget *box;
+	GError *error = NULL;
+	guint i;
+
+	/* The same compose rules everywhere, instead of the desktop's IME */
+	g_setenv ("GTK_IM_MODULE", "gtk-im-context-simple", TRUE);
+
+	context = g_option_context_new ("- measure the input to paint latency of SexySpellEntry");
+	g_option_context_add_main_entries (context, options, NULL);
+	g_option_context_add_group (context, gtk_get_option_group (FALSE));
+	if (!g_option_context_parse (context, &argc, &argv, &error))
+	{
+		g_printerr ("bench-latency: %s\n", error->message);
+		return 1;
+	}
+	g_option_context_free (context);
+
+	if (!gtk_init_check (&argc, &argv))
+	{
+		g_printerr ("bench-latency: no display, skipped\n");
+		return 77;
+	}
+
+	checker = bench_checker_new (lang ? lang : "en_US", &error);
+	if (checker == NULL)
+	{
+		g_printerr ("bench-latency: %s, skipped\n", error->message);
+		g_error_free (error);
+		return 77;
+	}
+
+	g_object_set (gtk_settings_get_default (), "gtk-entry-select-on-focus", FALSE, NULL);
+	rate = CLAMP(rate, 1, 1000);
+
+	h.loop = g_main_loop_new (NULL, FALSE);
+	h.prefill = bench_corpus_generate (BENCH_CORPUS_NATURAL, PREFILL_SIZE);
+	h.paste = bench_corpus_generate (BENCH_CORPUS_NATURAL, PASTE_SIZE);
+	h.pending = g_array_new (FALSE, FALSE, sizeof (Pending));
+	h.latencies = g_array_new (FALSE, FALSE, sizeof (gint64));
+	h.handling = g_array_new (FALSE, FALSE, sizeof (gint64));
+	h.entries = g_ptr_array_new ();
+
+	h.window = gtk_window_new (GTK_WINDOW_TOPLEVEL);
+	box = gtk_box_new (GTK_ORIENTATION_VERTICAL, 6);
+	gtk_container_set_border_width (GTK_CONTAINER(box), 6);
+	gtk_container_add (GTK_CONTAINER(h.window), box);
+
+	for (i = 0; i < (guint) MAX(n_entries, 1); i++)
+	{
+		GtkWidget *entry = sexy_spell_entry_new ();
+
+		/* All entries share the checker, like the entries of a form */
+		sexy_spell_entry_set_checker (SEXY_SPELL_ENTRY(entry), checker);
+		gtk_entry_set_width_chars (GTK_ENTRY(entry), 80);
+		g_signal_connect (entry, "changed", G_CALLBACK(entry_changed), &h);
+		g_signal_connect (entry, "preedit-changed", G_CALLBACK(entry_preedit_changed), &h);
+		g_signal_connect_after (entry, "populate-popup", G_CALLBACK(populate_popup), &h);
+		gtk_box_pack_start (GTK_BOX(box), entry, FALSE, FALSE, 0);
+		g_ptr_array_add (h.entries, entry);
+	}
+	g_object_unref (checker);
+
+	gtk_widget_show_all (h.window);
+	gtk_window_present (GTK_WINDOW(h.window));
+	g_signal_connect (gtk_widget_get_frame_clock (h.window), "after-paint", G_CALLBACK(after_paint), &h);
+	gtk_widget_add_tick_callback (h.window, tick, &h, NULL);
+
+	g_print ("# display: %s\n", gdk_display_get_name (gtk_widget_get_display (h.window)));
+	g_print ("# entries: %u\n", h.entries->len);
+	g_print ("# rate: %d events/s\n", rate);
+	g_print ("session\tevents\tp50_us\tp90_us\tp99_us\tmax_us\thandle_p50_us\thandle_p99_us\tlost\tframes\tdropped\n");
+
+	for (i = 0; i < G_N_ELEMENTS (scripts); i++)
+	{
+		if (is_selected (&scripts[i]))
+			run_session (&h, &scripts[i]);
+	}
+
+	gtk_widget_destroy (h.window);
+	g_ptr_array_unref (h.entries);
+	g_array_unref (h.handling);
+	g_array_unref (h.latencies);
+	g_array_unref (h.pending);
+	g_free (h.paste);
+	g_free (h.prefill);
+	g_main_loop_unref (h.loop);
+	g_strfreev (sessions);
+	g_free (lang);
+
+	return 0;
+}
@@ -0,0 +1,37 @@
+#!/bin/sh
+#
+# Runs bench-latency on a display of its own: Xvfb by default, or GDK's
+# Broadway backend with --broadway. Every other argument is passed on,
+# for example
+#
+#   ./bench-latency.sh --broadway -n 8 -r 30 -s typing
+#
+# Exits with 77 when neither is installed.
+
+dir=$(dirname "$0")
+
+if test "x$1" = "x--broadway"; then
+	shift
+	if ! command -v broadwayd >/dev/null 2>&1; then
+		echo "$0: broadwayd not found, skipped" >&2
+		exit 77
+	fi
+
+	display=:${BROADWAY_DISPLAY_NUMBER:-57}
+	broadwayd "$display" >/dev/null 2>&1 &
+	pid=$!
+	sleep 1
+
+	GDK_BACKEND=broadway BROADWAY_DISPLAY=$display "$dir/bench-latency" "$@"
+	status=$?
+
+	kill $pid
+	exit $status
+fi
+
+if ! command -v xvfb-run >/dev/null 2>&1; then
+	echo "$0: xvfb-run not found, skipped" >&2
+	exit 77
+fi
+
+exec xvfb-run -a -s "-screen 0 1280x1024x24" env GDK_BACKEND=x11 "$dir/bench-latency" "$@"
@@ -0,0 +1,576 @@
+/*
+ * @file benchmarks/bench-micro.c Micro-benchmarks of the checking pipeline
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+/*
+ * Measures every stage of checking on its own, on the fixed texts of
+ * bench-corpus.c, and prints one tab-separated line per case:
+ *
+ *   case  words  ns_per_word  allocs_per_word  peak_rss_kb
+ *
+ * where words is the number of words one pass goes through. Lines
+ * starting with # describe the run. Every case runs in a process of its
+ * own, so the peak RSS is that of the case alone. Reports of two
+ * revisions are compared with bench-compare.sh.
+ *
+ * The cases are
+ *
+ *   tokenize     splitting the text into words, as the entry does
+ *   recheck      checking a whole entry again with warm verdicts
+ *   attributes   rebuilding the underlines, per misspelled word
+ *   word-check   emitting ::word-check with the default handler
+ *   suggest      suggestions for misspelled words, from the backend
+ *   codetable    turning language codes into names
+ *
+ * Cases that need a display or a dictionary are skipped without one.
+ * See bench-backend.c for checking against a fixed word list.
+ *
+ * Usage: bench-micro [LANGUAGE [CASE...]]
+ *
+ * where CASE selects the cases starting with it, like "recheck" or
+ * "tokenize/natural".
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdio.h>
+#include <string.h>
+
+#include <gtk/gtk.h>
+
+#ifdef G_OS_UNIX
+# include <sys/resource.h>
+# include <sys/wait.h>
+# include <unistd.h>
+#endif
+
+#include "sexy-spell-entry.h"
+#include "sexy-tokenizer.h"
+#include "gtkspell-iso-codes.h"
+#include "bench-alloc.h"
+#include "bench-backend.h"
+#include "bench-corpus.h"
+
+#define TEXT_SIZE 16384
+#define MAX_SUGGEST 32
+#define MIN_TIME (G_USEC_PER_SEC / 2)
+
+typedef struct
+{
+	guint n_words;
+	guint64 total_words;
+	gint64 start;
+	gint64 elapsed;
+	guint start_allocs;
+	guint n_allocs;
+} Result;
+
+typedef gboolean (*CaseFunc) (BenchCorpus corpus, Result *result, GError **error);
+
+typedef struct
+{
+	const gchar *name;
+	CaseFunc func;
+	BenchCorpus corpus;
+} Case;
+
+static const gchar *lang = "en_US";
+
+static void
+result_start (Result *result)
+{
+	result->start_allocs = bench_alloc_count ();
+	result->start = g_get_monotonic_time ();
+}
+
+/* Counts one pass over @n_words, and returns TRUE until enough time
+ * has been spent to trust the numbers */
+static gboolean
+result_next (Result *result, guint n_words)
+{
+	result->n_words = n_words;
+	result->total_words += n_words;
+	result->elapsed = g_get_monotonic_time () - result->start;
+	if (result->elapsed < MIN_TIME)
+		return TRUE;
+
+	result->n_allocs = bench_alloc_count () - result->start_allocs;
+	return FALSE;
+}
+
+static void
+drain (void)
+{
+	while (g_main_context_iteration (NULL, FALSE));
+}
+
+static guint
+count_words (const gchar *text)
+{
+	SexyWordList *words = sexy_word_list_new ();
+	gint len = (gint) strlen (text);
+	guint n;
+
+	sexy_tokenize (text, len, 0, len, words);
+	n = words->len;
+	sexy_word_list_free (words);
+
+	return n;
+}
+
+/* The distinct misspelled words of @text, at most @max of them */
+static GPtrArray *
+find_misspelled (SexySpellChecker *checker, const gchar *text, guint max)
+{
+	GPtrArray *misspelled = g_ptr_array_new_with_free_func (g_free);
+	GHashTable *seen = g_hash_table_new (g_str_hash, g_str_equal);
+	GArray *spans;
+	guint i;
+
+	spans = sexy_spell_checker_check_text (checker, text, -1);
+	for (i = 0; i < spans->len && misspelled->len < max; i++)
+	{
+		SexySpellSpan *span = &g_array_index (spans, SexySpellSpan, i);
+		gchar *word = g_strndup (text + span->start, span->end - span->start);
+
+		if (g_hash_table_contains (seen, word))
+		{
+			g_free (word);
+			continue;
+		}
+		g_hash_table_add (seen, word);
+		g_ptr_array_add (misspelled, word);
+	}
+	g_array_unref (spans);
+	g_hash_table_destroy (seen);
+
+	return misspelled;
+}
+
+/* An entry holding @text, checked and with every verdict cached */
+static GtkWidget *
+entry_new (const gchar *text, GError **error)
+{
+	SexySpellChecker *checker;
+	GtkWidget *entry;
+
+	if (!gtk_init_check (NULL, NULL))
+	{
+		g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, "no display");
+		return NULL;
+	}
+
+	checker = bench_checker_new (lang, error);
+	if (checker == NULL)
+		return NULL;
+
+	entry = g_object_ref_sink (sexy_spell_entry_new ());
+	sexy_spell_entry_set_checker (SEXY_SPELL_ENTRY(entry), checker);
+	sexy_spell_entry_set_async_check (SEXY_SPELL_ENTRY(entry), FALSE);
+	sexy_spell_entry_set_prefetch_suggestions (SEXY_SPELL_ENTRY(entry), FALSE);
+	g_object_unref (checker);
+
+	gtk_entry_set_text (GTK_ENTRY(entry), text);
+	drain ();
+
+	return entry;
+}
+
+static void
+entry_free (GtkWidget *entry)
+{
+	gtk_widget_destroy (entry);
+	g_object_unref (entry);
+}
+
+static gboolean
+bench_tokenize (BenchCorpus corpus, Result *result, GError **error)
+{
+	SexyWordList *words = sexy_word_list_new ();
+	gchar *text = bench_corpus_generate (corpus, TEXT_SIZE);
+	gint len = (gint) strlen (text);
+
+	sexy_tokenize (text, len, 0, len, words);
+
+	result_start (result);
+	do
+	{
+		sexy_word_list_clear (words);
+		sexy_tokenize (text, len, 0, len, words);
+	}
+	while (result_next (result, words->len));
+
+	sexy_word_list_free (words);
+	g_free (text);
+
+	return TRUE;
+}
+
+static gboolean
+bench_recheck (BenchCorpus corpus, Result *result, GError **error)
+{
+	gchar *text = bench_corpus_generate (corpus, TEXT_SIZE);
+	SexySpellChecker *checker;
+	GtkWidget *entry;
+	guint n_words;
+
+	entry = entry_new (text, error);
+	if (entry == NULL)
+	{
+		g_free (text);
+		return FALSE;
+	}
+
+	/* A change of the checker makes the entry check everything again */
+	checker = sexy_spell_entry_get_checker (SEXY_SPELL_ENTRY(entry));
+	n_words = count_words (text);
+
+	result_start (result);
+	do
+	{
+		g_signal_emit_by_name (checker, "changed");
+		drain ();
+	}
+	while (result_next (result, n_words));
+
+	entry_free (entry);
+	g_free (text);
+
+	return TRUE;
+}
+
+static gboolean
+bench_attributes (BenchCorpus corpus, Result *result, GError **error)
+{
+	gchar *text = bench_corpus_generate (corpus, TEXT_SIZE);
+	GtkWidget *entry, *unchecked;
+	GArray *spans;
+	gint64 start;
+	guint n_spans, allocs;
+	guint64 i, n_passes;
+
+	entry = entry_new (text, error);
+	if (entry == NULL)
+	{
+		g_free (text);
+		return FALSE;
+	}
+
+	spans = sexy_spell_checker_check_text (sexy_spell_entry_get_checker (SEXY_SPELL_ENTRY(entry)), text, -1);
+	n_spans = spans->len;
+	g_array_unref (spans);
+
+	if (n_spans == 0)
+	{
+		g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, "no misspelled words");
+		entry_free (entry);
+		g_free (text);
+		return FALSE;
+	}
+
+	/* A style change rebuilds the underlines. What GtkEntry itself does
+	 * on a style change is measured on an unchecked entry and taken off. */
+	result_start (result);
+	do
+	{
+		g_signal_emit_by_name (entry, "style-updated");
+	}
+	while (result_next (result, n_spans));
+	entry_free (entry);
+
+	unchecked = entry_new (text, NULL);
+	if (unchecked != NULL)
+	{
+		sexy_spell_entry_set_checked (SEXY_SPELL_ENTRY(unchecked), FALSE);
+		n_passes = result->total_words / n_spans;
+
+		allocs = bench_alloc_count ();
+		start = g_get_monotonic_time ();
+		for (i = 0; i < n_passes; i++)
+			g_signal_emit_by_name (unchecked, "style-updated");
+		result->elapsed = MAX(result->elapsed - (g_get_monotonic_time () - start), 0);
+		result->n_allocs = MAX((gint) result->n_allocs - (gint) (bench_alloc_count () - allocs), 0);
+
+		entry_free (unchecked);
+	}
+
+	g_free (text);
+
+	return TRUE;
+}
+
+static gboolean
+bench_word_check (BenchCorpus corpus, Result *result, GError **error)
+{
+	gchar *text = bench_corpus_generate (corpus, TEXT_SIZE);
+	SexyWordList *list = sexy_word_list_new ();
+	GPtrArray *words;
+	GtkWidget *entry;
+	gint len = (gint) strlen (text);
+	guint i;
+
+	entry = entry_new (text, error);
+	if (entry == NULL)
+	{
+		sexy_word_list_free (list);
+		g_free (text);
+		return FALSE;
+	}
+
+	words = g_ptr_array_new_with_free_func (g_free);
+	sexy_tokenize (text, len, 0, len, list);
+	for (i = 0; i < list->len; i++)
+		g_ptr_array_add (words, g_strndup (text + list->starts[i], list->ends[i] - list->starts[i]));
+
+	result_start (result);
+	do
+	{
+		for (i = 0; i < words->len; i++)
+		{
+			gboolean misspelled;
+
+			g_signal_emit_by_name (entry, "word-check", g_ptr_array_index (words, i), &misspelled);
+		}
+	}
+	while (result_next (result, words->len));
+
+	g_ptr_array_unref (words);
+	sexy_word_list_free (list);
+	entry_free (entry);
+	g_free (text);
+
+	return TRUE;
+}
+
+static gboolean
+bench_suggest (BenchCorpus corpus, Result *result, GError **error)
+{
+	gchar *text = bench_corpus_generate (corpus, TEXT_SIZE);
+	SexySpellBackendInterface *iface;
+	SexySpellBackend *backend;
+	SexySpellChecker *checker;
+	GPtrArray *misspelled;
+	gpointer dict;
+	guint i;
+
+	checker = bench_checker_new (lang, error);
+	if (checker == NULL)
+	{
+		g_free (text);
+		return FALSE;
+	}
+
+	misspelled = find_misspelled (checker, text, MAX_SUGGEST);
+	backend = sexy_spell_checker_get_backend (checker);
+	iface = SEXY_SPELL_BACKEND_GET_IFACE(backend);
+	dict = iface->request_dict (backend, lang);
+
+	if (misspelled->len == 0 || dict == NULL)
+	{
+		g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, "no misspelled words");
+		if (dict != NULL)
+			iface->free_dict (backend, dict);
+		g_ptr_array_unref (misspelled);
+		g_object_unref (checker);
+		g_free (text);
+		return FALSE;
+	}
+
+	result_start (result);
+	do
+	{
+		for (i = 0; i < misspelled->len; i++)
+			g_strfreev (iface->suggest (backend, dict, g_ptr_array_index (misspelled, i), -1));
+	}
+	while (result_next (result, misspelled->len));
+
+	iface->free_dict (backend, dict);
+	g_ptr_array_unref (misspelled);
+	g_object_unref (checker);
+	g_free (text);
+
+	return TRUE;
+}
+
+static gboolean
+bench_codetable (BenchCorpus corpus, Result *result, GError **error)
+{
+	static const gchar *codes[] = {
+		"en", "en_US", "en_GB", "de_DE", "de_CH", "fr_FR", "fr_CA", "es_ES",
+		"es_MX", "pt_BR", "pt_PT", "it_IT", "nl_NL", "sv_SE", "nb_NO", "da_DK",
+		"fi_FI", "pl_PL", "cs_CZ", "ru_RU", "uk_UA", "el_GR", "tr_TR", "hu_HU",
+		"xx", "xx_YY",
+	};
+	guint i;
+
+	result_start (result);
+	do
+	{
+		for (i = 0; i < G_N_ELEMENTS (codes); i++)
+		{
+			const gchar *language = NULL, *country = NULL;
+
+			codetable_lookup (codes[i], &language, &country);
+		}
+	}
+	while (result_next (result, G_N_ELEMENTS (codes)));
+
+	return TRUE;
+}
+
+static const Case cases[] = {
+	{ "tokenize/synthetic", bench_tokenize, BENCH_CORPUS_SYNTHETIC },
+	{ "tokenize/natural", bench_tokenize, BENCH_CORPUS_NATURAL },
+	{ "recheck/synthetic", bench_recheck, BENCH_CORPUS_SYNTHETIC },
+	{ "recheck/natural", bench_recheck, BENCH_CORPUS_NATURAL },
+	{ "attributes/synthetic", bench_attributes, BENCH_CORPUS_SYNTHETIC },
+	{ "attributes/natural", bench_attributes, BENCH_CORPUS_NATURAL },
+	{ "word-check/synthetic", bench_word_check, BENCH_CORPUS_SYNTHETIC },
+	{ "word-check/natural", bench_word_check, BENCH_CORPUS_NATURAL },
+	{ "suggest/synthetic", bench_suggest, BENCH_CORPUS_SYNTHETIC },
+	{ "suggest/natural", bench_suggest, BENCH_CORPUS_NATURAL },
+	{ "codetable/lookup", bench_codetable, BENCH_CORPUS_NATURAL },
+};
+
+static glong
+get_peak_rss (void)
+{
+#ifdef G_OS_UNIX
+	struct rusage usage;
+
+	if (getrusage (RUSAGE_SELF, &usage) == 0)
+		return usage.ru_maxrss;
+#endif
+	return -1;
+}
+
+/* Returns 0 if the case ran, 77 if it was skipped */
+static gint
+run_case_here (const Case *c)
+{
+	Result result = { 0, };
+	GError *error = NULL;
+	glong rss;
+
+	if (!c->func (c->corpus, &result, &error))
+	{
+		g_printerr ("bench-micro: %s: %s, skipped\n", c->name, error->message);
+		g_error_free (error);
+		return 77;
+	}
+
+	g_print ("%s\t%u\t%.1f", c->name, result.n_words, (gdouble) result.elapsed * 1000 / result.total_words);
+
+	if (bench_alloc_supported ())
+		g_print ("\t%.3f", (gdouble) result.n_allocs / result.total_words);
+	else
+		g_print ("\t-");
+
+	rss = get_peak_rss ();
+	if (rss >= 0)
+		g_print ("\t%ld\n", rss);
+	else
+		g_print ("\t-\n");
+
+	return 0;
+}
+
+static gint
+run_case (const Case *c)
+{
+#ifdef G_OS_UNIX
+	gint status;
+	pid_t pid;
+
+	fflush (stdout);
+	pid = fork ();
+	if (pid == 0)
+	{
+		status = run_case_here (c);
+		fflush (stdout);
+		_exit (status);
+	}
+
+	if (pid < 0 || waitpid (pid, &status, 0) < 0 || !WIFEXITED(status))
+	{
+		g_printerr ("bench-micro: %s: crashed\n", c->name);
+		return 1;
+	}
+	return WEXITSTATUS(status);
+#else
+	return run_case_here (c);
+#endif
+}
+
+static gboolean
+is_selected (const Case *c, gint argc, char **argv)
+{
+	gint i;
+
+	if (argc <= 2)
+		return TRUE;
+
+	for (i = 2; i < argc; i++)
+	{
+		if (g_str_has_prefix (c->name, argv[i]))
+			return TRUE;
+	}
+	return FALSE;
+}
+
+int
+main (int argc, char **argv)
+{
+	gboolean failed = FALSE, ran = FALSE;
+	guint i;
+
+	if (argc > 1)
+		lang = argv[1];
+
+#if defined(__AVX2__)
+	g_print ("# classifier: AVX2\n");
+#elif defined(__SSE2__)
+	g_print ("# classifier: SSE2\n");
+#else
+	g_print ("# classifier: scalar\n");
+#endif
+	g_print ("# language: %s\n", lang);
+	g_print ("# wordlist: %s\n", g_getenv ("SEXY_BENCH_WORDLIST") ? g_getenv ("SEXY_BENCH_WORDLIST") : "-");
+	g_print ("# text size: %d\n", TEXT_SIZE);
+	g_print ("case\twords\tns_per_word\tallocs_per_word\tpeak_rss_kb\n");
+
+	for (i = 0; i < G_N_ELEMENTS (cases); i++)
+	{
+		gint status;
+
+		if (!is_selected (&cases[i], argc, argv))
+			continue;
+
+		status = run_case (&cases[i]);
+		if (status == 0)
+			ran = TRUE;
+		else if (status != 77)
+			failed = TRUE;
+	}
+
+	if (failed)
+		return 1;
+	return ran ? 0 : 77;
+}
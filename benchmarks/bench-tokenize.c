@@ -0,0 +1,102 @@
+/*
+ * @file benchmarks/bench-tokenize.c Word splitting throughput
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+/*
+ * Splits a text into words over and over and reports the words per
+ * second of the byte classifier next to those of Pango's word breaking,
+ * once for plain ASCII text and once for text with some accented words.
+ *
+ * Usage: bench-tokenize [SIZE]
+ */
+
+#include <stdlib.h>
+
+#include <glib.h>
+
+#include "sexy-tokenizer.h"
+
+#define ASCII_SAMPLE "The quick brown fox jumps over the lazy dog, but teh lazy dgo " \
+                     "does not notice. Spelling mistakes like recieve and seperate " \
+                     "are common in everyday writing. "
+#define MIXED_SAMPLE "The naïve café owner doesn't notice the façade, but the " \
+                     "rôle of the résumé is clear to everyone in the room. "
+
+#define MIN_TIME G_USEC_PER_SEC / 2
+
+typedef void (*TokenizeFunc) (const gchar *text, gint text_len, gint start, gint end,
+                              SexyWordList *words);
+
+static gdouble
+words_per_second (TokenizeFunc tokenize, const gchar *text, gint len, SexyWordList *words)
+{
+	gint64 start, elapsed;
+	guint64 n_words = 0;
+
+	start = g_get_monotonic_time ();
+	do
+	{
+		sexy_word_list_clear (words);
+		tokenize (text, len, 0, len, words);
+		n_words += words->len;
+		elapsed = g_get_monotonic_time () - start;
+	}
+	while (elapsed < MIN_TIME);
+
+	return (gdouble) n_words * G_USEC_PER_SEC / elapsed;
+}
+
+static void
+run (const gchar *name, const gchar *sample, gsize size)
+{
+	SexyWordList *words = sexy_word_list_new ();
+	GString *text = g_string_new (NULL);
+	gdouble fast, pango;
+
+	while (text->len < size)
+		g_string_append (text, sample);
+
+	fast = words_per_second (sexy_tokenize, text->str, (gint) text->len, words);
+	pango = words_per_second (sexy_tokenize_pango, text->str, (gint) text->len, words);
+
+	g_print ("%s text, %u words:\n", name, words->len);
+	g_print ("  classifier:          %.0f words/s\n", fast);
+	g_print ("  pango:               %.0f words/s (%.1fx)\n", pango, fast / pango);
+
+	g_string_free (text, TRUE);
+	sexy_word_list_free (words);
+}
+
+int
+main (int argc, char **argv)
+{
+	gsize size = argc > 1 ? (gsize) atoi (argv[1]) : 65536;
+
+#if defined(__AVX2__)
+	g_print ("classifier:            AVX2\n");
+#elif defined(__SSE2__)
+	g_print ("classifier:            SSE2\n");
+#else
+	g_print ("classifier:            scalar\n");
+#endif
+
+	run ("ASCII", ASCII_SAMPLE, size);
+	run ("Mixed", MIXED_SAMPLE, size);
+
+	return 0;
+}
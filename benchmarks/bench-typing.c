@@ -0,0 +1,131 @@
+/*
+ * @file benchmarks/bench-typing.c Checking cost per keystroke
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+/*
+ * Types a text into a SexySpellEntry one character at a time and reports
+ * the time and the heap allocations spent checking after each keystroke.
+ * The text is typed twice and only the second round is measured, when
+ * the verdict cache and the word storage are warm.
+ *
+ * Usage: bench-typing [LANGUAGE] [SIZE]
+ *
+ * See bench-backend.c for checking against a fixed word list.
+ */
+
+#include <stdlib.h>
+
+#include <gtk/gtk.h>
+
+#include "sexy-spell-entry.h"
+#include "bench-alloc.h"
+#include "bench-backend.h"
+
+#define SAMPLE "The quick brown fox jumps over the lazy dog, but teh lazy dgo " \
+               "does not notice. Spelling mistakes like recieve and seperate " \
+               "are common in everyday writing. "
+
+typedef struct
+{
+	guint n_keys;
+	gint64 total_time;
+	gint64 max_time;
+	guint n_allocs;
+} Round;
+
+static void
+type_text (GtkWidget *entry, const gchar *text, Round *round)
+{
+	const gchar *p;
+
+	gtk_entry_set_text (GTK_ENTRY(entry), "");
+	while (g_main_context_iteration (NULL, FALSE));
+
+	for (p = text; *p; p = g_utf8_next_char (p))
+	{
+		gint position = -1;
+		gint64 start;
+		guint allocs;
+
+		gtk_editable_set_position (GTK_EDITABLE(entry), -1);
+		position = gtk_editable_get_position (GTK_EDITABLE(entry));
+		gtk_editable_insert_text (GTK_EDITABLE(entry), p, g_utf8_next_char (p) - p, &position);
+
+		/* The check runs from an idle, the entry is not realized */
+		allocs = bench_alloc_count ();
+		start = g_get_monotonic_time ();
+		while (g_main_context_iteration (NULL, FALSE));
+		start = g_get_monotonic_time () - start;
+
+		round->n_allocs += bench_alloc_count () - allocs;
+		round->total_time += start;
+		round->max_time = MAX(round->max_time, start);
+		round->n_keys++;
+	}
+}
+
+int
+main (int argc, char **argv)
+{
+	const gchar *lang = argc > 1 ? argv[1] : "en_US";
+	gsize size = argc > 2 ? (gsize) atoi (argv[2]) : 4096;
+	SexySpellChecker *checker;
+	GtkWidget *entry;
+	GString *text;
+	Round warmup = { 0, }, round = { 0, };
+	GError *error = NULL;
+
+	if (!gtk_init_check (&argc, &argv))
+	{
+		g_printerr ("bench-typing: no display, skipped\n");
+		return 77;
+	}
+
+	checker = bench_checker_new (lang, &error);
+	if (checker == NULL)
+	{
+		g_printerr ("bench-typing: %s, skipped\n", error->message);
+		g_error_free (error);
+		return 77;
+	}
+
+	entry = g_object_ref_sink (sexy_spell_entry_new ());
+	sexy_spell_entry_set_checker (SEXY_SPELL_ENTRY(entry), checker);
+	g_object_unref (checker);
+
+	text = g_string_new (NULL);
+	while (text->len < size)
+		g_string_append (text, SAMPLE);
+	g_string_truncate (text, size);
+
+	type_text (entry, text->str, &warmup);
+	type_text (entry, text->str, &round);
+
+	g_print ("language:              %s\n", lang);
+	g_print ("keystrokes:            %u\n", round.n_keys);
+	g_print ("check time per key:    %.1f us (max %" G_GINT64_FORMAT " us)\n",
+	         (gdouble) round.total_time / round.n_keys, round.max_time);
+	if (bench_alloc_supported ())
+		g_print ("allocations per key:   %.2f\n", (gdouble) round.n_allocs / round.n_keys);
+
+	g_string_free (text, TRUE);
+	gtk_widget_destroy (entry);
+	g_object_unref (entry);
+
+	return 0;
+}
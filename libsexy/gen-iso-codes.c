@@ -0,0 +1,197 @@
+/* gtkspell - a spell-checking addon for GTK's TextView widget
+ * Copyright (c) 2013 Sandro Mani
+ *
+ * Based on gtkhtml-editor-spell-language.c code which is
+ * Copyright (C) 2008 Novell, Inc.
+ *
+ *    This program is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License along
+ *    with this program; if not, write to the Free Software Foundation, Inc.,
+ *    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * Turns iso_639.xml and iso_3166.xml into the tables searched by
+ * gtkspell-iso-codes.c, so the XML is parsed at build time instead of
+ * on the way to the first window.
+ *
+ * Usage: gen-iso-codes ISO_639_XML ISO_3166_XML > gtkspell-iso-codes-table.h
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+
+typedef struct
+{
+	const gchar *element;
+	const gchar *code_attribute;
+	GHashTable *names;
+} IsoCodesFile;
+
+static void
+start_element (GMarkupParseContext *context,
+               const gchar *element_name,
+               const gchar **attribute_names,
+               const gchar **attribute_values,
+               gpointer data,
+               GError **error)
+{
+	IsoCodesFile *file = data;
+	const gchar *name = NULL;
+	const gchar *code = NULL;
+	int i;
+
+	if (strcmp (element_name, file->element) != 0)
+		return;
+
+	for (i = 0; attribute_names[i] != NULL; i++)
+	{
+		if (strcmp (attribute_names[i], "name") == 0)
+			name = attribute_values[i];
+		else if (strcmp (attribute_names[i], file->code_attribute) == 0)
+			code = attribute_values[i];
+	}
+
+	if (code != NULL && *code != '\0' && name != NULL && *name != '\0')
+		g_hash_table_insert (file->names, g_strdup (code), g_strdup (name));
+}
+
+static gboolean
+parse (IsoCodesFile *file, const gchar *filename, GError **error)
+{
+	GMarkupParser parser = { start_element, NULL, NULL, NULL, NULL };
+	GMarkupParseContext *context;
+	gchar *contents;
+	gsize length;
+	gboolean ret;
+
+	if (!g_file_get_contents (filename, &contents, &length, error))
+		return FALSE;
+
+	context = g_markup_parse_context_new (&parser, 0, file, NULL);
+	ret = g_markup_parse_context_parse (context, contents, length, error) &&
+	      g_markup_parse_context_end_parse (context, error);
+	g_markup_parse_context_free (context);
+	g_free (contents);
+
+	return ret;
+}
+
+/* Appends @str with its terminating NUL to the pool, as a C literal */
+static guint
+pool_add (GString *pool, guint *pool_length, const gchar *str)
+{
+	guint offset = *pool_length;
+	const guchar *p;
+
+	g_string_append (pool, "\t\"");
+	for (p = (const guchar *) str; *p; p++)
+	{
+		if (*p == '"' || *p == '\\')
+			g_string_append_printf (pool, "\\%c", *p);
+		else if (*p < 0x20 || *p >= 0x7f)
+			g_string_append_printf (pool, "\\%03o", *p);
+		else
+			g_string_append_c (pool, *p);
+	}
+	g_string_append (pool, "\\0\"\n");
+
+	*pool_length += strlen (str) + 1;
+	return offset;
+}
+
+static gint
+compare_codes (gconstpointer a, gconstpointer b)
+{
+	return strcmp (*(const gchar * const *) a, *(const gchar * const *) b);
+}
+
+static void
+write_table (GString *out, GString *pool, guint *pool_length,
+             const gchar *table_name, GHashTable *names)
+{
+	GPtrArray *codes;
+	GHashTableIter iter;
+	gpointer key;
+	guint i;
+
+	codes = g_ptr_array_new ();
+	g_hash_table_iter_init (&iter, names);
+	while (g_hash_table_iter_next (&iter, &key, NULL))
+		g_ptr_array_add (codes, key);
+
+	/* Sorted like strcmp() does, for bsearch() */
+	g_ptr_array_sort (codes, compare_codes);
+
+	g_string_append_printf (out, "static const IsoCode %s[] = {\n", table_name);
+	for (i = 0; i < codes->len; i++)
+	{
+		const gchar *code = g_ptr_array_index (codes, i);
+		guint code_offset = pool_add (pool, pool_length, code);
+		guint name_offset = pool_add (pool, pool_length, g_hash_table_lookup (names, code));
+
+		g_string_append_printf (out, "\t{ %u, %u },\n", code_offset, name_offset);
+	}
+	g_string_append (out, "};\n\n");
+
+	g_ptr_array_unref (codes);
+}
+
+int
+main (int argc, char **argv)
+{
+	IsoCodesFile iso_639 = { "iso_639_entry", "iso_639_1_code", NULL };
+	IsoCodesFile iso_3166 = { "iso_3166_entry", "alpha_2_code", NULL };
+	GString *tables, *pool;
+	guint pool_length = 0;
+	GError *error = NULL;
+
+	if (argc != 3)
+	{
+		g_printerr ("Usage: %s ISO_639_XML ISO_3166_XML\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	iso_639.names = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+	iso_3166.names = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+
+	if (!parse (&iso_639, argv[1], &error) || !parse (&iso_3166, argv[2], &error))
+	{
+		g_printerr ("%s: %s\n", argv[0], error->message);
+		g_error_free (error);
+		return EXIT_FAILURE;
+	}
+
+	if (g_hash_table_size (iso_639.names) == 0 || g_hash_table_size (iso_3166.names) == 0)
+	{
+		g_printerr ("%s: No codes found\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	tables = g_string_new (NULL);
+	pool = g_string_new (NULL);
+	write_table (tables, pool, &pool_length, "iso_639_codes", iso_639.names);
+	write_table (tables, pool, &pool_length, "iso_3166_codes", iso_3166.names);
+
+	g_print ("/* Generated by gen-iso-codes, do not edit. */\n\n");
+	g_print ("static const gchar iso_codes_strings[] =\n%s;\n\n", pool->str);
+	g_print ("%s", tables->str);
+
+	g_string_free (tables, TRUE);
+	g_string_free (pool, TRUE);
+	g_hash_table_unref (iso_639.names);
+	g_hash_table_unref (iso_3166.names);
+
+	return EXIT_SUCCESS;
+}
@@ -26,161 +26,70 @@
 #endif
 
 #include <libintl.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "gtkspell-iso-codes.h"
+#include "sexy-trace.h"
 
 #define ISO_639_DOMAIN	"iso_639"
 #define ISO_3166_DOMAIN	"iso_3166"
 
-static GHashTable *iso_639_table = NULL;
-static GHashTable *iso_3166_table = NULL;
-
-static void
-iso_639_start_element (GMarkupParseContext *context,
-                       const gchar *element_name,
-                       const gchar **attribute_names,
-                       const gchar **attribute_values,
-                       gpointer data,
-                       GError **error)
+/* Offsets into iso_codes_strings */
+typedef struct
 {
-  GHashTable *hash_table = data;
-  const gchar *name = NULL;
-  const gchar *code = NULL;
-  int i;
-
-  if (strcmp (element_name, "iso_639_entry") != 0)
-    return;
-
-  for (i = 0; attribute_names[i] != NULL; i++)
-    {
-      if (strcmp (attribute_names[i], "name") == 0)
-        name = attribute_values[i];
-      else if (strcmp (attribute_names[i], "iso_639_1_code") == 0)
-        code = attribute_values[i];
-    }
+  guint32 code;
+  guint32 name;
+} IsoCode;
 
-  if (code != NULL && *code != '\0' && name != NULL && *name != '\0')
-    g_hash_table_insert (hash_table, g_strdup (code),
-                         g_strdup (dgettext (ISO_639_DOMAIN, name)));
-}
+/* Generated from the iso-codes XML by gen-iso-codes, sorted by code.
+ * Being read-only data, it is simply mapped in with the library. */
+#include "gtkspell-iso-codes-table.h"
 
 static void
-iso_3166_start_element (GMarkupParseContext *context,
-                        const gchar *element_name,
-                        const gchar **attribute_names,
-                        const gchar **attribute_values,
-                        gpointer data,
-                        GError **error)
+codetable_bind_domains (void)
 {
-  GHashTable *hash_table = data;
-  const gchar *name = NULL;
-  const gchar *code = NULL;
-  int i;
-
-  if (strcmp (element_name, "iso_3166_entry") != 0)
-    return;
+#ifdef ENABLE_NLS
+  static gsize bound = 0;
 
-  for (i = 0; attribute_names[i] != NULL; i++)
+  if (g_once_init_enter (&bound))
     {
-      if (strcmp (attribute_names[i], "name") == 0)
-        name = attribute_values[i];
-      else if (strcmp (attribute_names[i], "alpha_2_code") == 0)
-        code = attribute_values[i];
-    }
+      SEXY_TRACE_BEGIN (codetable_bind_domains, NULL, 0);
 
-  if (code != NULL && *code != '\0' && name != NULL && *name != '\0')
-    g_hash_table_insert (hash_table, g_strdup (code),
-                         g_strdup (dgettext (ISO_3166_DOMAIN, name)));
-}
+      bindtextdomain (ISO_639_DOMAIN, ISO_CODES_LOCALEDIR);
+      bind_textdomain_codeset (ISO_639_DOMAIN, "UTF-8");
 
-static void
-iso_codes_parse (const GMarkupParser *parser,
-                 const gchar *basename,
-                 GHashTable *hash_table)
-{
-  GMappedFile *mapped_file;
-  gchar *filename;
-  GError *error = NULL;
+      bindtextdomain (ISO_3166_DOMAIN, ISO_CODES_LOCALEDIR);
+      bind_textdomain_codeset (ISO_3166_DOMAIN, "UTF-8");
 
-  filename = g_build_filename (ISO_CODES_PREFIX, "share", "xml", "iso-codes",
-                               basename, NULL);
-  mapped_file = g_mapped_file_new (filename, FALSE, &error);
-  g_free (filename);
-
-  if (mapped_file != NULL)
-    {
-      GMarkupParseContext *context;
-      const gchar *contents;
-      gsize length;
-
-      context = g_markup_parse_context_new (parser, 0, hash_table, NULL);
-      contents = g_mapped_file_get_contents (mapped_file);
-      length = g_mapped_file_get_length (mapped_file);
-      g_markup_parse_context_parse (context, contents, length, &error);
-      g_markup_parse_context_free (context);
-      g_mapped_file_unref (mapped_file);
-    }
-
-  if (error != NULL)
-    {
-      g_warning ("%s: %s", basename, error->message);
-      g_error_free (error);
+      SEXY_TRACE_END (codetable_bind_domains, NULL, 0);
+      g_once_init_leave (&bound, 1);
     }
+#endif
 }
 
-/**
- * codetable_init:
- *
- * Initializes the code table.
- */
-void
-codetable_init (void)
+static int
+compare_code (const void *key, const void *member)
 {
-  GMarkupParser iso_639_parser = {
-    iso_639_start_element, NULL, NULL, NULL, NULL
-  };
-
-  GMarkupParser iso_3166_parser = {
-    iso_3166_start_element, NULL, NULL, NULL, NULL
-  };
-
-  g_return_if_fail (iso_639_table == NULL);
-  g_return_if_fail (iso_3166_table == NULL);
-
-#ifdef ENABLE_NLS
-  bindtextdomain (ISO_639_DOMAIN, ISO_CODES_LOCALEDIR);
-  bind_textdomain_codeset (ISO_639_DOMAIN, "UTF-8");
-
-  bindtextdomain (ISO_3166_DOMAIN, ISO_CODES_LOCALEDIR);
-  bind_textdomain_codeset (ISO_3166_DOMAIN, "UTF-8");
-#endif
+  const IsoCode *iso_code = member;
 
-  iso_639_table = g_hash_table_new_full (g_str_hash, g_str_equal,
-                             (GDestroyNotify) g_free, (GDestroyNotify) g_free);
-  iso_3166_table = g_hash_table_new_full (g_str_hash, g_str_equal,
-                             (GDestroyNotify) g_free, (GDestroyNotify) g_free);
-
-  iso_codes_parse (&iso_639_parser, "iso_639.xml", iso_639_table);
-  iso_codes_parse (&iso_3166_parser, "iso_3166.xml", iso_3166_table);
+  return strcmp (key, iso_codes_strings + iso_code->code);
 }
 
-/**
- * codetable_free:
- *
- * Frees the code table.
- */
-void
-codetable_free (void)
+static const gchar *
+codetable_find (const IsoCode *table,
+                gsize n_codes,
+                const gchar *domain,
+                const gchar *code)
 {
-  g_return_if_fail (iso_639_table != NULL);
-  g_return_if_fail (iso_3166_table != NULL);
+  const IsoCode *found;
 
-  g_hash_table_unref (iso_639_table);
-  g_hash_table_unref (iso_3166_table);
+  found = bsearch (code, table, n_codes, sizeof (IsoCode), compare_code);
+  if (found == NULL)
+    return g_intern_string (code);
 
-  iso_639_table = NULL;
-  iso_3166_table = NULL;
+  /* Only the names that are looked up get translated */
+  return dgettext (domain, iso_codes_strings + found->name);
 }
 
 /**
@@ -194,38 +103,26 @@ codetable_free (void)
  * Looks up the language and country name for the specified language code.
  * If no matching entries are found, language_name and country_name will
  * simply contain the parts of the language code (i.e. "en" and "US").
+ * The country name is left untouched if the code has no country part.
  */
 void
 codetable_lookup (const gchar *language_code, const gchar **language_name, const gchar** country_name)
 {
   gchar **parts;
 
-  g_return_if_fail (iso_639_table != NULL);
-  g_return_if_fail (iso_3166_table != NULL);
+  codetable_bind_domains ();
 
   /* Split language code into parts. */
   parts = g_strsplit (language_code, "_", 2);
 
   g_return_if_fail (*parts != NULL);
 
-  *language_name = g_hash_table_lookup (iso_639_table, parts[0]);
-  if (*language_name == NULL)
-    {
-      g_hash_table_insert (iso_639_table, g_strdup (parts[0]),
-                           g_strdup (parts[0]));
-      *language_name = g_hash_table_lookup (iso_639_table, parts[0]);
-    }
+  *language_name = codetable_find (iso_639_codes, G_N_ELEMENTS (iso_639_codes),
+                                   ISO_639_DOMAIN, parts[0]);
 
   if (g_strv_length (parts) == 2)
-    {
-      *country_name = g_hash_table_lookup (iso_3166_table, parts[1]);
-      if (*country_name == NULL)
-        {
-          g_hash_table_insert (iso_3166_table, g_strdup (parts[1]),
-                               g_strdup (parts[1]));
-          *country_name = g_hash_table_lookup (iso_3166_table, parts[1]);
-        }
-    }
+    *country_name = codetable_find (iso_3166_codes, G_N_ELEMENTS (iso_3166_codes),
+                                    ISO_3166_DOMAIN, parts[1]);
 
   g_strfreev (parts);
 }
@@ -28,8 +28,6 @@
 
 G_BEGIN_DECLS
 
-void codetable_init   (void);
-void codetable_free   (void);
 void codetable_lookup (const gchar *language_code,
                        const gchar **language_name,
                        const gchar **country_name);
@@ -0,0 +1,177 @@
+/*
+ * @file libsexy/sexy-char-index.c Character to byte offset index
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "sexy-char-index.h"
+
+/*
+ * Remembers the byte offset of every STRIDE-th character of a text, so
+ * converting an offset only walks the characters since the nearest
+ * checkpoint instead of the whole text. Checkpoints are added as far as
+ * they are needed and dropped from the position of an edit onwards.
+ */
+
+#define STRIDE 64
+
+struct _SexyCharIndex
+{
+	/* Byte offset of character i * STRIDE */
+	GArray *checkpoints;
+};
+
+SexyCharIndex *
+sexy_char_index_new (void)
+{
+	SexyCharIndex *index = g_new0 (SexyCharIndex, 1);
+
+	index->checkpoints = g_array_new (FALSE, FALSE, sizeof (gint));
+	return index;
+}
+
+void
+sexy_char_index_free (SexyCharIndex *index)
+{
+	g_array_free (index->checkpoints, TRUE);
+	g_free (index);
+}
+
+/**
+ * sexy_char_index_invalidate:
+ * @index: A #SexyCharIndex.
+ * @pos: Byte offset where the text was changed.
+ *
+ * Forgets the checkpoints after @pos. One right at @pos stays valid, the
+ * characters before it did not change.
+ */
+void
+sexy_char_index_invalidate (SexyCharIndex *index, gint pos)
+{
+	GArray *checkpoints = index->checkpoints;
+	guint lo = 0, hi = checkpoints->len;
+
+	while (lo < hi)
+	{
+		guint mid = (lo + hi) / 2;
+
+		if (g_array_index (checkpoints, gint, mid) <= pos)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	g_array_set_size (checkpoints, lo);
+}
+
+/* Adds checkpoints up to the one for character n * STRIDE, or until the
+ * end of the text. Returns the number of checkpoints. */
+static guint
+extend (SexyCharIndex *index, const gchar *text, guint n)
+{
+	GArray *checkpoints = index->checkpoints;
+
+	if (checkpoints->len == 0)
+	{
+		gint zero = 0;
+
+		g_array_append_val (checkpoints, zero);
+	}
+
+	while (checkpoints->len <= n)
+	{
+		const gchar *p = text + g_array_index (checkpoints, gint, checkpoints->len - 1);
+		gint offset, i;
+
+		for (i = 0; i < STRIDE && *p; i++)
+			p = g_utf8_next_char (p);
+		if (i < STRIDE)
+			break;
+
+		offset = (gint) (p - text);
+		g_array_append_val (checkpoints, offset);
+	}
+
+	return checkpoints->len;
+}
+
+/**
+ * sexy_char_index_char_to_byte:
+ * @index: A #SexyCharIndex.
+ * @text: The text, which must not have changed since the last
+ *        sexy_char_index_invalidate().
+ * @char_offset: A character offset, clamped to the end of @text.
+ *
+ * Returns: The byte offset of the character.
+ */
+gint
+sexy_char_index_char_to_byte (SexyCharIndex *index, const gchar *text, gint char_offset)
+{
+	guint n = extend (index, text, char_offset / STRIDE);
+	guint k = MIN((guint) char_offset / STRIDE, n - 1);
+	const gchar *p = text + g_array_index (index->checkpoints, gint, k);
+	gint i;
+
+	for (i = char_offset - k * STRIDE; i > 0 && *p; i--)
+		p = g_utf8_next_char (p);
+
+	return (gint) (p - text);
+}
+
+/**
+ * sexy_char_index_byte_to_char:
+ * @index: A #SexyCharIndex.
+ * @text: The text, as for sexy_char_index_char_to_byte().
+ * @byte_offset: The byte offset of a character in @text.
+ *
+ * Returns: The character offset.
+ */
+gint
+sexy_char_index_byte_to_char (SexyCharIndex *index, const gchar *text, gint byte_offset)
+{
+	GArray *checkpoints = index->checkpoints;
+	guint lo, hi;
+
+	/* Make sure a checkpoint beyond byte_offset exists, if the text is
+	 * long enough */
+	while (g_array_index (checkpoints, gint, extend (index, text, 0) - 1) <= byte_offset)
+	{
+		guint len = checkpoints->len;
+
+		if (extend (index, text, len) == len)
+			break;
+	}
+
+	/* The last checkpoint at or before byte_offset */
+	lo = 0;
+	hi = checkpoints->len;
+	while (hi - lo > 1)
+	{
+		guint mid = (lo + hi) / 2;
+
+		if (g_array_index (checkpoints, gint, mid) <= byte_offset)
+			lo = mid;
+		else
+			hi = mid;
+	}
+
+	return (gint) (lo * STRIDE + g_utf8_pointer_to_offset (text + g_array_index (checkpoints, gint, lo),
+	                                                       text + byte_offset));
+}
@@ -0,0 +1,34 @@
+/*
+ * @file libsexy/sexy-char-index.h Character to byte offset index
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct _SexyCharIndex SexyCharIndex;
+
+SexyCharIndex *sexy_char_index_new (void);
+void sexy_char_index_free (SexyCharIndex *index);
+void sexy_char_index_invalidate (SexyCharIndex *index, gint pos);
+gint sexy_char_index_char_to_byte (SexyCharIndex *index, const gchar *text, gint char_offset);
+gint sexy_char_index_byte_to_char (SexyCharIndex *index, const gchar *text, gint byte_offset);
+
+G_END_DECLS
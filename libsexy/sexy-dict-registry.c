@@ -0,0 +1,637 @@
+/*
+ * @file libsexy/sexy-dict-registry.c Shared dictionaries
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <string.h>
+
+#include "sexy-dict-registry.h"
+#include "sexy-trace.h"
+
+/*
+ * One dictionary per backend and language, borrowed by every checker
+ * that has the language active. A dictionary lives as long as somebody
+ * holds it, and keeps its backend alive.
+ *
+ * Dictionaries are not thread-safe. A shared dictionary may be used by
+ * checkers on several threads, so every call into it is serialized by
+ * its own lock. Worker threads that look up many words get their own
+ * copies instead (see sexy_dict_registry_get_thread_dict()). Words added
+ * to a shared dictionary, and the replacements stored in it, are
+ * remembered and replayed into them.
+ */
+
+struct _SexyDict
+{
+	SexySpellBackend *backend;
+	gpointer handle;
+	gchar *lang;
+
+	/* Shared dictionaries only. @serial tells a dictionary apart from one
+	 * loaded again later for the same language. */
+	gboolean shared;
+	GMutex lock;
+	guint ref_count;
+	guint serial;
+	GPtrArray *words;	/* of Remembered, by @seq */
+	guint last_seq;
+
+	/* Thread copies only: the last word of the shared dictionary with
+	 * @replayed_serial that was added already */
+	guint replayed_serial;
+	guint replayed_seq;
+};
+
+/* A word added to a shared dictionary, or with @correction, a
+ * replacement stored in it. Storing another replacement for the same
+ * word moves it to the end with a new @seq. */
+typedef struct
+{
+	gchar *word;
+	gchar *correction;
+	guint seq;
+} Remembered;
+
+/* The shared dictionaries of one backend */
+typedef struct
+{
+	/* Requested tag to dictionary, a dictionary may have several */
+	GHashTable *by_tag;
+	/* Language the backend reports to dictionary, owns the dictionaries */
+	GHashTable *by_lang;
+} BackendDicts;
+
+typedef struct
+{
+	/* Backend to a table of language to dictionary or %NULL */
+	GHashTable *backends;
+	guint generation;
+} ThreadDicts;
+
+G_LOCK_DEFINE_STATIC (registry);
+static GHashTable *backends = NULL;
+static gint generation = 0;
+static gint replacement_generation = 0;
+static guint next_serial = 1;
+
+#define GET_IFACE(dict) SEXY_SPELL_BACKEND_GET_IFACE((dict)->backend)
+
+static SexyDict *
+dict_new (SexySpellBackend *backend, gpointer handle)
+{
+	SexyDict *dict = g_new0 (SexyDict, 1);
+
+	dict->backend = g_object_ref (backend);
+	dict->handle = handle;
+	dict->lang = g_strdup (SEXY_SPELL_BACKEND_GET_IFACE(backend)->describe_dict (backend, handle));
+	g_mutex_init (&dict->lock);
+
+	return dict;
+}
+
+static void
+dict_free (SexyDict *dict)
+{
+	if (dict == NULL)
+		return;
+
+	GET_IFACE(dict)->free_dict (dict->backend, dict->handle);
+	if (dict->words)
+		g_ptr_array_unref (dict->words);
+	g_object_unref (dict->backend);
+	g_free (dict->lang);
+	g_mutex_clear (&dict->lock);
+	g_free (dict);
+}
+
+/* Thread copies belong to one thread and need no locking */
+static void
+dict_lock (SexyDict *dict)
+{
+	if (dict->shared)
+		g_mutex_lock (&dict->lock);
+}
+
+static void
+dict_unlock (SexyDict *dict)
+{
+	if (dict->shared)
+		g_mutex_unlock (&dict->lock);
+}
+
+static void
+remembered_free (Remembered *remembered)
+{
+	g_free (remembered->word);
+	g_free (remembered->correction);
+	g_free (remembered);
+}
+
+static void
+backend_dicts_free (BackendDicts *bd)
+{
+	g_hash_table_destroy (bd->by_tag);
+	g_hash_table_destroy (bd->by_lang);
+	g_free (bd);
+}
+
+/**
+ * sexy_dict_registry_request:
+ * @backend: The backend to load the dictionary from.
+ * @lang: The language in a form @backend understands.
+ *
+ * Borrows the shared dictionary for @lang, loading it on first use.
+ * This may be called from any thread.
+ *
+ * Returns: The dictionary, to be given back with
+ * sexy_dict_registry_release(), or %NULL if @backend has none.
+ */
+SexyDict *
+sexy_dict_registry_request (SexySpellBackend *backend, const gchar *lang)
+{
+	BackendDicts *bd;
+	SexyDict *dict, *loaded;
+	gpointer handle;
+
+	G_LOCK (registry);
+	bd = backends ? g_hash_table_lookup (backends, backend) : NULL;
+	dict = bd ? g_hash_table_lookup (bd->by_tag, lang) : NULL;
+	if (dict != NULL)
+	{
+		dict->ref_count++;
+		G_UNLOCK (registry);
+		return dict;
+	}
+	G_UNLOCK (registry);
+
+	/* Loading takes a while, and must not hold up the main thread
+	 * releasing or adding words to other dictionaries meanwhile */
+	SEXY_TRACE_BEGIN (load_dict, backend, strlen (lang));
+	handle = SEXY_SPELL_BACKEND_GET_IFACE(backend)->request_dict (backend, lang);
+	SEXY_TRACE_END (load_dict, backend, strlen (lang));
+	if (handle == NULL)
+		return NULL;
+	loaded = dict_new (backend, handle);
+
+	G_LOCK (registry);
+
+	if (backends == NULL)
+		backends = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
+		                                  (GDestroyNotify) backend_dicts_free);
+
+	bd = g_hash_table_lookup (backends, backend);
+	if (bd == NULL)
+	{
+		bd = g_new0 (BackendDicts, 1);
+		bd->by_tag = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+		bd->by_lang = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, (GDestroyNotify) dict_free);
+		g_hash_table_insert (backends, backend, bd);
+	}
+
+	/* Another thread may have loaded the same tag in the meantime, and
+	 * different tags may resolve to the same dictionary */
+	dict = g_hash_table_lookup (bd->by_tag, lang);
+	if (dict == NULL)
+	{
+		dict = g_hash_table_lookup (bd->by_lang, loaded->lang);
+		if (dict == NULL)
+		{
+			dict = loaded;
+			loaded = NULL;
+			dict->shared = TRUE;
+			dict->words = g_ptr_array_new_with_free_func ((GDestroyNotify) remembered_free);
+			dict->serial = next_serial++;
+			g_hash_table_insert (bd->by_lang, dict->lang, dict);
+		}
+		g_hash_table_insert (bd->by_tag, g_strdup (lang), dict);
+	}
+
+	dict->ref_count++;
+
+	/* Freed like any other dictionary, with the lock held */
+	dict_free (loaded);
+	G_UNLOCK (registry);
+
+	return dict;
+}
+
+/**
+ * sexy_dict_registry_ref:
+ * @dict: A dictionary from sexy_dict_registry_request().
+ *
+ * Borrows @dict once more, for instance to keep it alive while a menu
+ * that offers it is shown.
+ *
+ * Returns: @dict, to be given back with sexy_dict_registry_release().
+ */
+SexyDict *
+sexy_dict_registry_ref (SexyDict *dict)
+{
+	G_LOCK (registry);
+	dict->ref_count++;
+	G_UNLOCK (registry);
+
+	return dict;
+}
+
+/**
+ * sexy_dict_registry_release:
+ * @dict: A dictionary from sexy_dict_registry_request().
+ *
+ * Gives back a dictionary, freeing it if nobody else uses it.
+ */
+void
+sexy_dict_registry_release (SexyDict *dict)
+{
+	SexySpellBackend *backend = dict->backend;
+	BackendDicts *bd;
+	GHashTableIter iter;
+	gpointer value;
+
+	G_LOCK (registry);
+
+	bd = backends ? g_hash_table_lookup (backends, backend) : NULL;
+	if (bd == NULL || dict->ref_count == 0)
+	{
+		G_UNLOCK (registry);
+		g_return_if_reached ();
+	}
+
+	if (--dict->ref_count > 0)
+	{
+		G_UNLOCK (registry);
+		return;
+	}
+
+	g_hash_table_iter_init (&iter, bd->by_tag);
+	while (g_hash_table_iter_next (&iter, NULL, &value))
+	{
+		if (value == dict)
+			g_hash_table_iter_remove (&iter);
+	}
+
+	/* This frees @dict, and may drop the last reference to @backend */
+	g_hash_table_remove (bd->by_lang, dict->lang);
+	if (g_hash_table_size (bd->by_lang) == 0)
+		g_hash_table_remove (backends, backend);
+
+	G_UNLOCK (registry);
+}
+
+/**
+ * sexy_dict_registry_list_languages:
+ * @backend: A backend.
+ *
+ * Lists the languages @backend has dictionaries for.
+ *
+ * Returns: (transfer full) (element-type utf8): The languages, free
+ * with g_slist_free_full() and g_free().
+ */
+GSList *
+sexy_dict_registry_list_languages (SexySpellBackend *backend)
+{
+	GSList *langs = NULL;
+	gchar **strv;
+	guint i;
+
+	strv = SEXY_SPELL_BACKEND_GET_IFACE(backend)->list_languages (backend);
+	for (i = 0; strv && strv[i]; i++)
+		langs = g_slist_prepend (langs, strv[i]);
+	g_free (strv);
+
+	return g_slist_reverse (langs);
+}
+
+/**
+ * sexy_dict_registry_get_lang:
+ * @dict: A dictionary.
+ *
+ * Gets the language the backend reports for @dict.
+ *
+ * Returns: (transfer full): The language, free with g_free().
+ */
+gchar *
+sexy_dict_registry_get_lang (SexyDict *dict)
+{
+	return g_strdup (dict->lang);
+}
+
+/**
+ * sexy_dict_registry_get_backend:
+ * @dict: A dictionary.
+ *
+ * Returns: (transfer none): The backend @dict was loaded from.
+ */
+SexySpellBackend *
+sexy_dict_registry_get_backend (SexyDict *dict)
+{
+	return dict->backend;
+}
+
+static void
+remember_word_unlocked (SexyDict *dict, const gchar *word, const gchar *correction)
+{
+	Remembered *remembered;
+	guint i;
+
+	if (dict->words == NULL)
+		return;
+
+	for (i = 0; i < dict->words->len; i++)
+	{
+		remembered = g_ptr_array_index (dict->words, i);
+		if ((remembered->correction != NULL) == (correction != NULL) &&
+		    strcmp (remembered->word, word) == 0)
+			break;
+	}
+
+	if (i < dict->words->len)
+	{
+		if (correction == NULL)
+			return;
+		g_ptr_array_remove_index (dict->words, i);
+	}
+
+	remembered = g_new (Remembered, 1);
+	remembered->seq = ++dict->last_seq;
+	remembered->word = g_strdup (word);
+	remembered->correction = g_strdup (correction);
+	g_ptr_array_add (dict->words, remembered);
+}
+
+/**
+ * sexy_dict_registry_add_to_personal:
+ * @dict: A shared dictionary.
+ * @word: The word to add.
+ *
+ * Adds @word to the personal word list of @dict. Every user of the
+ * dictionary sees the change.
+ */
+void
+sexy_dict_registry_add_to_personal (SexyDict *dict, const gchar *word)
+{
+	G_LOCK (registry);
+	dict_lock (dict);
+	GET_IFACE(dict)->add_to_personal (dict->backend, dict->handle, word);
+	dict_unlock (dict);
+	remember_word_unlocked (dict, word, NULL);
+	G_UNLOCK (registry);
+
+	g_atomic_int_inc (&generation);
+}
+
+/**
+ * sexy_dict_registry_add_to_session:
+ * @dict: A shared dictionary.
+ * @word: The word to ignore.
+ *
+ * Adds @word to the session word list of @dict. Every user of the
+ * dictionary sees the change.
+ */
+void
+sexy_dict_registry_add_to_session (SexyDict *dict, const gchar *word)
+{
+	G_LOCK (registry);
+	dict_lock (dict);
+	GET_IFACE(dict)->add_to_session (dict->backend, dict->handle, word);
+	dict_unlock (dict);
+	remember_word_unlocked (dict, word, NULL);
+	G_UNLOCK (registry);
+
+	g_atomic_int_inc (&generation);
+}
+
+/**
+ * sexy_dict_registry_get_generation:
+ *
+ * Returns: A counter that changes whenever the word lists of a shared
+ * dictionary change, so cached verdicts can be dropped.
+ */
+guint
+sexy_dict_registry_get_generation (void)
+{
+	return (guint) g_atomic_int_get (&generation);
+}
+
+/**
+ * sexy_dict_registry_get_suggestion_generation:
+ *
+ * Returns: A counter that changes whenever the word lists of a shared
+ * dictionary change or a replacement is stored in one, so cached
+ * suggestions can be dropped. Verdicts do not depend on replacements.
+ */
+guint
+sexy_dict_registry_get_suggestion_generation (void)
+{
+	return (guint) g_atomic_int_get (&generation) + (guint) g_atomic_int_get (&replacement_generation);
+}
+
+static void
+thread_dicts_free (ThreadDicts *td)
+{
+	g_hash_table_destroy (td->backends);
+	g_free (td);
+}
+
+static GPrivate thread_dicts = G_PRIVATE_INIT ((GDestroyNotify) thread_dicts_free);
+
+/* Adds the words added to the shared dictionary since the last call,
+ * and stores the replacements stored in it */
+static void
+replay_words (SexyDict *dict)
+{
+	BackendDicts *bd;
+	SexyDict *shared;
+	guint i;
+
+	G_LOCK (registry);
+	bd = backends ? g_hash_table_lookup (backends, dict->backend) : NULL;
+	shared = bd ? g_hash_table_lookup (bd->by_lang, dict->lang) : NULL;
+	if (shared != NULL)
+	{
+		if (dict->replayed_serial != shared->serial)
+		{
+			dict->replayed_serial = shared->serial;
+			dict->replayed_seq = 0;
+		}
+
+		for (i = shared->words->len; i > 0; i--)
+		{
+			Remembered *remembered = g_ptr_array_index (shared->words, i - 1);
+
+			if (remembered->seq <= dict->replayed_seq)
+				break;
+		}
+
+		for (; i < shared->words->len; i++)
+		{
+			Remembered *remembered = g_ptr_array_index (shared->words, i);
+
+			if (remembered->correction != NULL)
+				GET_IFACE(dict)->store_replacement (dict->backend, dict->handle,
+				                                    remembered->word, remembered->correction);
+			else
+				GET_IFACE(dict)->add_to_session (dict->backend, dict->handle, remembered->word);
+		}
+		dict->replayed_seq = shared->last_seq;
+	}
+	G_UNLOCK (registry);
+}
+
+/**
+ * sexy_dict_registry_get_thread_dict:
+ * @backend: The backend to load the dictionary from.
+ * @lang: The language in a form @backend understands.
+ *
+ * Gets a copy of the dictionary for @lang that belongs to the calling
+ * thread, so it can be used without locking. It is loaded on first use
+ * and freed when the thread exits. Words added to the shared dictionary
+ * are added to the copy as well.
+ *
+ * Returns: (transfer none): The dictionary or %NULL if @backend has none.
+ */
+SexyDict *
+sexy_dict_registry_get_thread_dict (SexySpellBackend *backend, const gchar *lang)
+{
+	ThreadDicts *td = g_private_get (&thread_dicts);
+	guint gen = sexy_dict_registry_get_suggestion_generation ();
+	GHashTableIter iter, dict_iter;
+	GHashTable *dicts;
+	gpointer handle, value;
+	SexyDict *dict;
+
+	if (td == NULL)
+	{
+		td = g_new0 (ThreadDicts, 1);
+		td->backends = g_hash_table_new_full (g_direct_hash, g_direct_equal, g_object_unref,
+		                                      (GDestroyNotify) g_hash_table_destroy);
+		td->generation = gen;
+		g_private_set (&thread_dicts, td);
+	}
+
+	else if (td->generation != gen)
+	{
+		g_hash_table_iter_init (&iter, td->backends);
+		while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &dicts))
+		{
+			g_hash_table_iter_init (&dict_iter, dicts);
+			while (g_hash_table_iter_next (&dict_iter, NULL, &value))
+			{
+				if (value != NULL)
+					replay_words (value);
+			}
+		}
+		td->generation = gen;
+	}
+
+	dicts = g_hash_table_lookup (td->backends, backend);
+	if (dicts == NULL)
+	{
+		dicts = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) dict_free);
+		g_hash_table_insert (td->backends, g_object_ref (backend), dicts);
+	}
+
+	if (g_hash_table_lookup_extended (dicts, lang, NULL, (gpointer *) &dict))
+		return dict;
+
+	dict = NULL;
+	handle = SEXY_SPELL_BACKEND_GET_IFACE(backend)->request_dict (backend, lang);
+	if (handle != NULL)
+	{
+		dict = dict_new (backend, handle);
+		replay_words (dict);
+	}
+
+	/* Failures are remembered too, so they are not retried for every word */
+	g_hash_table_insert (dicts, g_strdup (lang), dict);
+
+	return dict;
+}
+
+/**
+ * sexy_dict_check:
+ * @dict: A dictionary.
+ * @word: The word to check.
+ * @length: The length of @word in bytes, or -1 if it is nul-terminated.
+ *
+ * Returns: %TRUE if @word is spelled correctly.
+ */
+gboolean
+sexy_dict_check (SexyDict *dict, const gchar *word, gssize length)
+{
+	gboolean ret;
+
+	dict_lock (dict);
+	ret = GET_IFACE(dict)->check (dict->backend, dict->handle, word, length);
+	dict_unlock (dict);
+
+	return ret;
+}
+
+/**
+ * sexy_dict_suggest:
+ * @dict: A dictionary.
+ * @word: A misspelled word.
+ *
+ * Returns: (transfer full): Corrections for @word, free with g_strfreev().
+ */
+gchar **
+sexy_dict_suggest (SexyDict *dict, const gchar *word)
+{
+	gchar **suggestions;
+
+	SEXY_TRACE_BEGIN (suggest, dict->backend, strlen (word));
+	dict_lock (dict);
+	suggestions = GET_IFACE(dict)->suggest (dict->backend, dict->handle, word, -1);
+	dict_unlock (dict);
+	SEXY_TRACE_END (suggest, dict->backend, strlen (word));
+	if (suggestions == NULL)
+		suggestions = g_new0 (gchar *, 1);
+
+	return suggestions;
+}
+
+/**
+ * sexy_dict_store_replacement:
+ * @dict: A shared dictionary.
+ * @misspelled: The misspelled word.
+ * @correction: The correction that was picked.
+ *
+ * Tells the backend which correction was picked, so it can be suggested
+ * first next time. Suggestions are computed from thread copies, so the
+ * replacement is replayed into them like an added word, and suggestions
+ * cached before are dropped.
+ */
+void
+sexy_dict_store_replacement (SexyDict *dict, const gchar *misspelled, const gchar *correction)
+{
+	if (GET_IFACE(dict)->store_replacement == NULL)
+		return;
+
+	G_LOCK (registry);
+	dict_lock (dict);
+	GET_IFACE(dict)->store_replacement (dict->backend, dict->handle, misspelled, correction);
+	dict_unlock (dict);
+	remember_word_unlocked (dict, misspelled, correction);
+	G_UNLOCK (registry);
+
+	g_atomic_int_inc (&replacement_generation);
+}
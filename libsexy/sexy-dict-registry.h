@@ -0,0 +1,46 @@
+/*
+ * @file libsexy/sexy-dict-registry.h Shared dictionaries
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+#pragma once
+
+#include <glib.h>
+
+#include "sexy-spell-backend.h"
+
+G_BEGIN_DECLS
+
+typedef struct _SexyDict SexyDict;
+
+SexyDict *sexy_dict_registry_request (SexySpellBackend *backend, const gchar *lang);
+SexyDict *sexy_dict_registry_ref (SexyDict *dict);
+void sexy_dict_registry_release (SexyDict *dict);
+GSList *sexy_dict_registry_list_languages (SexySpellBackend *backend);
+gchar *sexy_dict_registry_get_lang (SexyDict *dict);
+SexySpellBackend *sexy_dict_registry_get_backend (SexyDict *dict);
+void sexy_dict_registry_add_to_personal (SexyDict *dict, const gchar *word);
+void sexy_dict_registry_add_to_session (SexyDict *dict, const gchar *word);
+guint sexy_dict_registry_get_generation (void);
+guint sexy_dict_registry_get_suggestion_generation (void);
+SexyDict *sexy_dict_registry_get_thread_dict (SexySpellBackend *backend, const gchar *lang);
+
+gboolean sexy_dict_check (SexyDict *dict, const gchar *word, gssize length);
+gchar **sexy_dict_suggest (SexyDict *dict, const gchar *word);
+void sexy_dict_store_replacement (SexyDict *dict, const gchar *misspelled, const gchar *correction);
+
+G_END_DECLS
@@ -0,0 +1,238 @@
+/*
+ * @file libsexy/sexy-enchant-backend.c Dictionaries from Enchant
+ *
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <enchant.h>
+
+#include "sexy-enchant-backend.h"
+
+/*
+ * EnchantBroker is not thread-safe, so every thread that requests a
+ * dictionary gets a broker of its own. A dictionary keeps its broker
+ * alive, since it may be freed after the thread that loaded it is gone.
+ */
+
+struct _SexyEnchantBackend
+{
+	GObject parent_instance;
+};
+
+typedef struct
+{
+	EnchantBroker *broker;
+	gint ref_count;
+} Broker;
+
+typedef struct
+{
+	EnchantDict *dict;
+	Broker *broker;
+	gchar *lang;
+} Dict;
+
+static void sexy_enchant_backend_iface_init (SexySpellBackendInterface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (SexyEnchantBackend, sexy_enchant_backend, G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (SEXY_TYPE_SPELL_BACKEND, sexy_enchant_backend_iface_init))
+
+static void
+broker_unref (Broker *broker)
+{
+	if (!g_atomic_int_dec_and_test (&broker->ref_count))
+		return;
+
+	enchant_broker_free (broker->broker);
+	g_free (broker);
+}
+
+static GPrivate thread_broker = G_PRIVATE_INIT ((GDestroyNotify) broker_unref);
+
+static Broker *
+get_thread_broker (void)
+{
+	Broker *broker = g_private_get (&thread_broker);
+
+	if (broker == NULL)
+	{
+		broker = g_new0 (Broker, 1);
+		broker->broker = enchant_broker_init ();
+		broker->ref_count = 1;
+		g_private_set (&thread_broker, broker);
+	}
+
+	return broker;
+}
+
+static void
+list_dicts_cb (const char * const lang_tag,
+               const char * const provider_name,
+               const char * const provider_desc,
+               const char * const provider_file,
+               void * user_data)
+{
+	g_ptr_array_add (user_data, g_strdup (lang_tag));
+}
+
+static gchar **
+sexy_enchant_backend_list_languages (SexySpellBackend *backend)
+{
+	GPtrArray *langs = g_ptr_array_new ();
+
+	enchant_broker_list_dicts (get_thread_broker ()->broker, list_dicts_cb, langs);
+	g_ptr_array_add (langs, NULL);
+
+	return (gchar **) g_ptr_array_free (langs, FALSE);
+}
+
+static void
+describe_cb (const char * const lang_tag,
+             const char * const provider_name,
+             const char * const provider_desc,
+             const char * const provider_file,
+             void * user_data)
+{
+	Dict *dict = user_data;
+
+	dict->lang = g_strdup (lang_tag);
+}
+
+static gpointer
+sexy_enchant_backend_request_dict (SexySpellBackend *backend, const gchar *lang)
+{
+	Broker *broker = get_thread_broker ();
+	EnchantDict *enchant_dict;
+	Dict *dict;
+
+	enchant_dict = enchant_broker_request_dict (broker->broker, lang);
+	if (enchant_dict == NULL)
+		return NULL;
+
+	dict = g_new0 (Dict, 1);
+	dict->dict = enchant_dict;
+	dict->broker = broker;
+	g_atomic_int_inc (&broker->ref_count);
+	enchant_dict_describe (enchant_dict, describe_cb, dict);
+
+	return dict;
+}
+
+static void
+sexy_enchant_backend_free_dict (SexySpellBackend *backend, gpointer data)
+{
+	Dict *dict = data;
+
+	enchant_broker_free_dict (dict->broker->broker, dict->dict);
+	broker_unref (dict->broker);
+	g_free (dict->lang);
+	g_free (dict);
+}
+
+static const gchar *
+sexy_enchant_backend_describe_dict (SexySpellBackend *backend, gpointer data)
+{
+	Dict *dict = data;
+
+	return dict->lang;
+}
+
+static gboolean
+sexy_enchant_backend_check (SexySpellBackend *backend, gpointer data, const gchar *word, gssize length)
+{
+	Dict *dict = data;
+
+	return enchant_dict_check (dict->dict, word, length) == 0;
+}
+
+static gchar **
+sexy_enchant_backend_suggest (SexySpellBackend *backend, gpointer data, const gchar *word, gssize length)
+{
+	Dict *dict = data;
+	gchar **suggestions, **ret;
+	size_t n_suggestions = 0, i;
+
+	suggestions = enchant_dict_suggest (dict->dict, word, length, &n_suggestions);
+
+	ret = g_new0 (gchar *, n_suggestions + 1);
+	for (i = 0; i < n_suggestions; i++)
+		ret[i] = g_strdup (suggestions[i]);
+
+	if (suggestions != NULL)
+		enchant_dict_free_suggestions (dict->dict, suggestions);
+
+	return ret;
+}
+
+static void
+sexy_enchant_backend_add_to_personal (SexySpellBackend *backend, gpointer data, const gchar *word)
+{
+	Dict *dict = data;
+
+	enchant_dict_add_to_personal (dict->dict, word, -1);
+}
+
+static void
+sexy_enchant_backend_add_to_session (SexySpellBackend *backend, gpointer data, const gchar *word)
+{
+	Dict *dict = data;
+
+	enchant_dict_add_to_session (dict->dict, word, -1);
+}
+
+static void
+sexy_enchant_backend_store_replacement (SexySpellBackend *backend, gpointer data,
+                                        const gchar *misspelled, const gchar *correction)
+{
+	Dict *dict = data;
+
+	enchant_dict_store_replacement (dict->dict, misspelled, -1, correction, -1);
+}
+
+static void
+sexy_enchant_backend_class_init (SexyEnchantBackendClass *klass)
+{
+}
+
+static void
+sexy_enchant_backend_iface_init (SexySpellBackendInterface *iface)
+{
+	iface->list_languages = sexy_enchant_backend_list_languages;
+	iface->request_dict = sexy_enchant_backend_request_dict;
+	iface->free_dict = sexy_enchant_backend_free_dict;
+	iface->describe_dict = sexy_enchant_backend_describe_dict;
+	iface->check = sexy_enchant_backend_check;
+	iface->suggest = sexy_enchant_backend_suggest;
+	iface->add_to_personal = sexy_enchant_backend_add_to_personal;
+	iface->add_to_session = sexy_enchant_backend_add_to_session;
+	iface->store_replacement = sexy_enchant_backend_store_replacement;
+}
+
+static void
+sexy_enchant_backend_init (SexyEnchantBackend *backend)
+{
+}
+
+SexySpellBackend *
+sexy_enchant_backend_new (void)
+{
+	return g_object_new (SEXY_TYPE_ENCHANT_BACKEND, NULL);
+}
@@ -0,0 +1,32 @@
+/*
+ * @file libsexy/sexy-enchant-backend.h Dictionaries from Enchant
+ *
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+#pragma once
+
+#include "sexy-spell-backend.h"
+
+G_BEGIN_DECLS
+
+#define SEXY_TYPE_ENCHANT_BACKEND (sexy_enchant_backend_get_type())
+G_DECLARE_FINAL_TYPE(SexyEnchantBackend, sexy_enchant_backend, SEXY, ENCHANT_BACKEND, GObject)
+
+SexySpellBackend *sexy_enchant_backend_new (void);
+
+G_END_DECLS
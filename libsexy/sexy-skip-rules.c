@@ -0,0 +1,292 @@
+/*
+ * @file libsexy/sexy-skip-rules.c Words that are never looked up
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <string.h>
+
+#include "sexy-skip-rules.h"
+#include "sexy-spell-checker.h"
+
+/*
+ * Skip rules decide from the text around a word whether it is looked up
+ * at all. They work on the token the word belongs to, which is the run
+ * of non-space characters around it without leading and trailing
+ * punctuation, since the word breaker splits URLs and paths into
+ * several words. Nothing here allocates, except for matching
+ * application patterns.
+ */
+
+#define LEADING_PUNCT "([{<\"'"
+#define TRAILING_PUNCT ".,;:!?)]}>\"'"
+
+/* Application patterns compiled so far, shared by all entries */
+G_LOCK_DEFINE_STATIC (patterns);
+static GHashTable *compiled = NULL;
+
+/**
+ * sexy_skip_pattern_compile:
+ * @pattern: A Perl-compatible regular expression.
+ * @error: Return location for a #GError.
+ *
+ * Compiles a pattern that has to match a whole token, or returns the
+ * one compiled before.
+ *
+ * Returns: A new reference to the regular expression, or %NULL if the
+ * pattern is invalid.
+ */
+GRegex *
+sexy_skip_pattern_compile (const gchar *pattern, GError **error)
+{
+	GRegex *regex;
+	gchar *anchored;
+
+	G_LOCK (patterns);
+
+	if (compiled == NULL)
+		compiled = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+		                                  (GDestroyNotify) g_regex_unref);
+
+	regex = g_hash_table_lookup (compiled, pattern);
+	if (regex == NULL)
+	{
+		anchored = g_strdup_printf ("(?:%s)\\z", pattern);
+		regex = g_regex_new (anchored, G_REGEX_ANCHORED | G_REGEX_OPTIMIZE, 0, error);
+		g_free (anchored);
+
+		if (regex != NULL)
+			g_hash_table_insert (compiled, g_strdup (pattern), regex);
+	}
+	if (regex != NULL)
+		g_regex_ref (regex);
+
+	G_UNLOCK (patterns);
+
+	return regex;
+}
+
+static gboolean
+has_prefix (const gchar *p, const gchar *end, const gchar *prefix)
+{
+	gsize len = strlen (prefix);
+
+	return (gsize) (end - p) >= len && g_ascii_strncasecmp (p, prefix, len) == 0;
+}
+
+static const gchar *
+find_str (const gchar *p, const gchar *end, const gchar *needle)
+{
+	gsize len = strlen (needle);
+
+	for (; (gsize) (end - p) >= len; p++)
+	{
+		if (memcmp (p, needle, len) == 0)
+			return p;
+	}
+	return NULL;
+}
+
+static gboolean
+is_url (const gchar *p, const gchar *end)
+{
+	const gchar *q, *at;
+
+	/* scheme://, bare www. hosts and mailto: */
+	q = find_str (p, end, "://");
+	if (q != NULL && q > p)
+	{
+		const gchar *s;
+
+		for (s = p; s < q && (g_ascii_isalnum (*s) || *s == '+' || *s == '-' || *s == '.'); s++)
+			;
+		if (s == q && g_ascii_isalpha (*p))
+			return TRUE;
+	}
+	if (has_prefix (p, end, "www.") || has_prefix (p, end, "mailto:"))
+		return TRUE;
+
+	/* Mail addresses */
+	at = memchr (p, '@', end - p);
+	return at != NULL && at > p && memchr (at, '.', end - at) != NULL;
+}
+
+static gboolean
+is_path (const gchar *p, const gchar *end)
+{
+	if (end - p < 2)
+		return FALSE;
+
+	if (*p == '/' || has_prefix (p, end, "~/") || has_prefix (p, end, "./") ||
+	    has_prefix (p, end, "../"))
+		return TRUE;
+
+	/* C:\ and C:/ */
+	if (end - p >= 3 && g_ascii_isalpha (p[0]) && p[1] == ':' &&
+	    (p[2] == '\\' || p[2] == '/'))
+		return TRUE;
+
+	return memchr (p, '\\', end - p) != NULL;
+}
+
+static gboolean
+is_hex (const gchar *p, const gchar *end)
+{
+	guint n_hex = 0, n_digits = 0;
+
+	if (has_prefix (p, end, "0x"))
+		return end - p > 2;
+
+	/* Hashes and UUIDs: long enough and not just a word like "facade" */
+	for (; p < end; p++)
+	{
+		if (g_ascii_isdigit (*p))
+			n_digits++;
+		else if (!g_ascii_isxdigit (*p) && *p != '-')
+			return FALSE;
+		n_hex += *p != '-';
+	}
+	return n_hex >= 6 && n_digits > 0;
+}
+
+static gboolean
+is_identifier_token (const gchar *p, const gchar *end)
+{
+	return find_str (p, end, "::") || find_str (p, end, "->") || find_str (p, end, "()");
+}
+
+static gboolean
+is_identifier_word (const gchar *word, const gchar *word_end)
+{
+	const gchar *w;
+
+	/* snake_case, camelCase and names with digits like utf8 */
+	for (w = word; w < word_end; w++)
+	{
+		if (*w == '_')
+			return TRUE;
+		if (w > word && g_ascii_isupper (*w) && g_ascii_islower (w[-1]))
+			return TRUE;
+		if (w > word && g_ascii_isdigit (*w) && g_ascii_isalpha (w[-1]))
+			return TRUE;
+	}
+	return FALSE;
+}
+
+/* The rules that look at the whole token [p, q) */
+static gboolean
+token_skipped (guint rules, GPtrArray *patterns, const gchar *p, const gchar *q)
+{
+	guint i;
+
+	if ((rules & SEXY_SKIP_CHANNELS) && p + 1 < q && *p == '#')
+		return TRUE;
+	if ((rules & SEXY_SKIP_URLS) && is_url (p, q))
+		return TRUE;
+	if ((rules & SEXY_SKIP_PATHS) && is_path (p, q))
+		return TRUE;
+	if ((rules & SEXY_SKIP_HEX) && is_hex (p, q))
+		return TRUE;
+	if ((rules & SEXY_SKIP_IDENTIFIERS) && is_identifier_token (p, q))
+		return TRUE;
+
+	for (i = 0; patterns != NULL && i < patterns->len; i++)
+	{
+		if (g_regex_match_full (g_ptr_array_index (patterns, i), p, q - p, 0, 0, NULL, NULL))
+			return TRUE;
+	}
+
+	return FALSE;
+}
+
+/**
+ * sexy_skip_cache_reset:
+ * @cache: A #SexySkipCache.
+ *
+ * Forgets the last token, to be called before the first word and
+ * whenever the text or the rules change.
+ */
+void
+sexy_skip_cache_reset (SexySkipCache *cache)
+{
+	cache->token_start = -1;
+	cache->token_end = -1;
+	cache->skipped = FALSE;
+}
+
+/**
+ * sexy_skip_rules_match:
+ * @rules: The enabled #SexySkipRules.
+ * @patterns: (element-type GRegex) (nullable): Patterns from
+ *            sexy_skip_pattern_compile().
+ * @text: The text.
+ * @text_len: The length of @text in bytes.
+ * @start: Byte offset of the word in @text.
+ * @end: Byte offset of the end of the word.
+ * @cache: (nullable): The token of the previous word.
+ *
+ * Checks whether the word should not be looked up in the dictionaries.
+ * A token is only scanned and matched once for all of its words, as
+ * long as they are checked one after the other with the same @cache.
+ *
+ * Returns: %TRUE if the word is skipped.
+ */
+gboolean
+sexy_skip_rules_match (guint rules, GPtrArray *patterns, const gchar *text, gint text_len,
+                       gint start, gint end, SexySkipCache *cache)
+{
+	SexySkipCache local;
+	const gchar *p, *q;
+
+	if ((rules & SEXY_SKIP_NUMBERS) && g_ascii_isdigit (text[start]))
+		return TRUE;
+
+	if (rules == 0 && (patterns == NULL || patterns->len == 0))
+		return FALSE;
+
+	if (cache == NULL)
+	{
+		cache = &local;
+		sexy_skip_cache_reset (cache);
+	}
+
+	if (start < cache->token_start || start >= cache->token_end)
+	{
+		/* Find the token around the word */
+		for (p = text + start; p > text && !g_ascii_isspace (p[-1]); p--)
+			;
+		for (q = text + end; q < text + text_len && !g_ascii_isspace (*q); q++)
+			;
+		cache->token_start = (gint) (p - text);
+		cache->token_end = (gint) (q - text);
+
+		while (p < q && strchr (LEADING_PUNCT, *p) != NULL)
+			p++;
+		while (q > p && strchr (TRAILING_PUNCT, q[-1]) != NULL)
+			q--;
+
+		cache->skipped = token_skipped (rules, patterns, p, q);
+	}
+
+	if (cache->skipped)
+		return TRUE;
+
+	return (rules & SEXY_SKIP_IDENTIFIERS) && is_identifier_word (text + start, text + end);
+}
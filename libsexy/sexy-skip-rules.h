@@ -0,0 +1,41 @@
+/*
+ * @file libsexy/sexy-skip-rules.h Words that are never looked up
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* The token of the last word matched and whether it is skipped, so the
+ * following words of a long token are not scanned again. Only valid
+ * while the text and the rules stay the same. */
+typedef struct
+{
+	gint token_start;
+	gint token_end;
+	gboolean skipped;
+} SexySkipCache;
+
+GRegex *sexy_skip_pattern_compile (const gchar *pattern, GError **error);
+void sexy_skip_cache_reset (SexySkipCache *cache);
+gboolean sexy_skip_rules_match (guint rules, GPtrArray *patterns, const gchar *text,
+                                gint text_len, gint start, gint end, SexySkipCache *cache);
+
+G_END_DECLS
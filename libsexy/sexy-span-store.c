@@ -0,0 +1,308 @@
+/*
+ * @file libsexy/sexy-span-store.c Misspelled span storage
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <string.h>
+
+#include "sexy-span-store.h"
+
+/*
+ * Sorted, non-overlapping byte ranges kept in a gap buffer.
+ *
+ * Spans in front of the gap store absolute offsets, spans behind it store
+ * their distance to the end of the text. An edit moves the gap to its
+ * position, so everything after the edit is shifted just by updating
+ * the text length. Edits while typing are local, which keeps the gap
+ * moves short; lookups are a binary search over both halves.
+ */
+
+#define MIN_CAPACITY 16
+
+typedef struct
+{
+	gint start;
+	gint end;
+} SexySpan;
+
+struct _SexySpanStore
+{
+	SexySpan *spans;
+	guint capacity;
+	guint gap_start;
+	guint gap_end;
+	gint length;
+	gboolean changed;
+};
+
+SexySpanStore *
+sexy_span_store_new (void)
+{
+	SexySpanStore *store = g_new0 (SexySpanStore, 1);
+
+	store->capacity = MIN_CAPACITY;
+	store->spans = g_new (SexySpan, store->capacity);
+	store->gap_end = store->capacity;
+
+	return store;
+}
+
+void
+sexy_span_store_free (SexySpanStore *store)
+{
+	if (store == NULL)
+		return;
+
+	g_free (store->spans);
+	g_free (store);
+}
+
+static inline guint
+n_spans (SexySpanStore *store)
+{
+	return store->capacity - (store->gap_end - store->gap_start);
+}
+
+static inline SexySpan
+get_span (SexySpanStore *store, guint index)
+{
+	SexySpan span;
+
+	if (index < store->gap_start)
+		return store->spans[index];
+
+	span = store->spans[index + (store->gap_end - store->gap_start)];
+	span.start = store->length - span.start;
+	span.end = store->length - span.end;
+	return span;
+}
+
+static void
+move_gap (SexySpanStore *store, guint index)
+{
+	while (store->gap_start > index)
+	{
+		SexySpan *span = &store->spans[--store->gap_end];
+
+		*span = store->spans[--store->gap_start];
+		span->start = store->length - span->start;
+		span->end = store->length - span->end;
+	}
+
+	while (store->gap_start < index)
+	{
+		SexySpan *span = &store->spans[store->gap_start++];
+
+		*span = store->spans[store->gap_end++];
+		span->start = store->length - span->start;
+		span->end = store->length - span->end;
+	}
+}
+
+static void
+grow (SexySpanStore *store)
+{
+	guint n_after = store->capacity - store->gap_end;
+	guint capacity = store->capacity * 2;
+
+	store->spans = g_renew (SexySpan, store->spans, capacity);
+	memmove (store->spans + capacity - n_after, store->spans + store->gap_end,
+	         n_after * sizeof(SexySpan));
+
+	store->gap_end = capacity - n_after;
+	store->capacity = capacity;
+}
+
+/* Index of the first span whose end is >= @offset */
+static guint
+lower_bound_end (SexySpanStore *store, gint offset)
+{
+	guint lo = 0, hi = n_spans (store);
+
+	while (lo < hi)
+	{
+		guint mid = lo + (hi - lo) / 2;
+
+		if (get_span (store, mid).end < offset)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/* Index of the first span whose start is >= @offset */
+static guint
+lower_bound_start (SexySpanStore *store, gint offset)
+{
+	guint lo = 0, hi = n_spans (store);
+
+	while (lo < hi)
+	{
+		guint mid = lo + (hi - lo) / 2;
+
+		if (get_span (store, mid).start < offset)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/**
+ * sexy_span_store_reset:
+ * @store: A #SexySpanStore.
+ * @length: The length of the text in bytes.
+ *
+ * Removes all spans.
+ */
+void
+sexy_span_store_reset (SexySpanStore *store, gint length)
+{
+	if (n_spans (store) != 0)
+		store->changed = TRUE;
+
+	store->gap_start = 0;
+	store->gap_end = store->capacity;
+	store->length = length;
+}
+
+/**
+ * sexy_span_store_edit:
+ * @store: A #SexySpanStore.
+ * @pos: Byte offset of the edit.
+ * @n_deleted: Number of bytes removed at @pos.
+ * @n_inserted: Number of bytes inserted at @pos.
+ *
+ * Updates the spans for an edit of the text. Spans touching the edited
+ * range are removed, spans after it are moved.
+ */
+void
+sexy_span_store_edit (SexySpanStore *store, gint pos, gint n_deleted, gint n_inserted)
+{
+	move_gap (store, lower_bound_end (store, pos));
+
+	while (store->gap_end < store->capacity &&
+	       store->length - store->spans[store->gap_end].start <= pos + n_deleted)
+	{
+		store->gap_end++;
+		store->changed = TRUE;
+	}
+
+	if (store->gap_end < store->capacity && n_inserted != n_deleted)
+		store->changed = TRUE;
+
+	store->length += n_inserted - n_deleted;
+}
+
+/**
+ * sexy_span_store_add:
+ * @store: A #SexySpanStore.
+ * @start: Start byte offset.
+ * @end: End byte offset.
+ *
+ * Adds a span, which must not overlap any span already in @store.
+ */
+void
+sexy_span_store_add (SexySpanStore *store, gint start, gint end)
+{
+	move_gap (store, lower_bound_start (store, start));
+
+	if (store->gap_start == store->gap_end)
+		grow (store);
+
+	store->spans[store->gap_start].start = start;
+	store->spans[store->gap_start].end = end;
+	store->gap_start++;
+	store->changed = TRUE;
+}
+
+/**
+ * sexy_span_store_remove:
+ * @store: A #SexySpanStore.
+ * @start: Start byte offset of the span.
+ *
+ * Removes the span starting at @start, if any.
+ */
+void
+sexy_span_store_remove (SexySpanStore *store, gint start)
+{
+	guint index = lower_bound_start (store, start);
+
+	if (index >= n_spans (store) || get_span (store, index).start != start)
+		return;
+
+	move_gap (store, index);
+	store->gap_end++;
+	store->changed = TRUE;
+}
+
+/**
+ * sexy_span_store_contains:
+ * @store: A #SexySpanStore.
+ * @start: Start byte offset of the span.
+ *
+ * Returns: %TRUE if a span starts at @start.
+ */
+gboolean
+sexy_span_store_contains (SexySpanStore *store, gint start)
+{
+	guint index = lower_bound_start (store, start);
+
+	return index < n_spans (store) && get_span (store, index).start == start;
+}
+
+guint
+sexy_span_store_get_n_spans (SexySpanStore *store)
+{
+	return n_spans (store);
+}
+
+void
+sexy_span_store_get_span (SexySpanStore *store, guint index, gint *start, gint *end)
+{
+	SexySpan span;
+
+	g_return_if_fail (index < n_spans (store));
+
+	span = get_span (store, index);
+	*start = span.start;
+	*end = span.end;
+}
+
+/**
+ * sexy_span_store_get_changed:
+ * @store: A #SexySpanStore.
+ *
+ * Returns: %TRUE if spans were added, removed or moved since the last
+ * call to sexy_span_store_clear_changed().
+ */
+gboolean
+sexy_span_store_get_changed (SexySpanStore *store)
+{
+	return store->changed;
+}
+
+void
+sexy_span_store_clear_changed (SexySpanStore *store)
+{
+	store->changed = FALSE;
+}
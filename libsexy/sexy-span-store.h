@@ -0,0 +1,40 @@
+/*
+ * @file libsexy/sexy-span-store.h Misspelled span storage
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct _SexySpanStore SexySpanStore;
+
+SexySpanStore *sexy_span_store_new (void);
+void sexy_span_store_free (SexySpanStore *store);
+void sexy_span_store_reset (SexySpanStore *store, gint length);
+void sexy_span_store_edit (SexySpanStore *store, gint pos, gint n_deleted, gint n_inserted);
+void sexy_span_store_add (SexySpanStore *store, gint start, gint end);
+void sexy_span_store_remove (SexySpanStore *store, gint start);
+gboolean sexy_span_store_contains (SexySpanStore *store, gint start);
+guint sexy_span_store_get_n_spans (SexySpanStore *store);
+void sexy_span_store_get_span (SexySpanStore *store, guint index, gint *start, gint *end);
+gboolean sexy_span_store_get_changed (SexySpanStore *store);
+void sexy_span_store_clear_changed (SexySpanStore *store);
+
+G_END_DECLS
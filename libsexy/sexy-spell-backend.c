@@ -0,0 +1,71 @@
+/*
+ * @file libsexy/sexy-spell-backend.c Dictionary backends
+ *
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "sexy-spell-backend.h"
+#include "sexy-enchant-backend.h"
+
+/**
+ * SECTION: sexy-spell-backend
+ * @short_description: Where dictionaries come from
+ * @title: SpellBackend
+ * @see_also: #SexySpellChecker, #SexyWordlistBackend
+ * @include: libsexy3/sexy-spell-backend.h
+ *
+ * A #SexySpellChecker looks words up in dictionaries loaded by a
+ * backend. The default one, from sexy_spell_backend_get_default(), uses
+ * Enchant and whatever dictionaries are installed.
+ * #SexyWordlistBackend checks against plain word lists instead, which
+ * gives the same results everywhere.
+ *
+ * Dictionaries are shared by all checkers that use the same backend, see
+ * sexy_spell_checker_new_with_backend().
+ */
+
+G_DEFINE_INTERFACE (SexySpellBackend, sexy_spell_backend, G_TYPE_OBJECT)
+
+static void
+sexy_spell_backend_default_init (SexySpellBackendInterface *iface)
+{
+}
+
+/**
+ * sexy_spell_backend_get_default:
+ *
+ * Gets the backend used by checkers that were not given one, which
+ * loads dictionaries through Enchant.
+ *
+ * Returns: (transfer none): The default #SexySpellBackend.
+ *
+ * Since: 1.2
+ */
+SexySpellBackend *
+sexy_spell_backend_get_default(void)
+{
+	static gsize backend = 0;
+
+	if (g_once_init_enter (&backend))
+		g_once_init_leave (&backend, (gsize) sexy_enchant_backend_new ());
+
+	return (SexySpellBackend *) backend;
+}
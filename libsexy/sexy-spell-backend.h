@@ -0,0 +1,76 @@
+/*
+ * @file libsexy/sexy-spell-backend.h Dictionary backends
+ *
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+#pragma once
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define SEXY_TYPE_SPELL_BACKEND (sexy_spell_backend_get_type())
+G_DECLARE_INTERFACE(SexySpellBackend, sexy_spell_backend, SEXY, SPELL_BACKEND, GObject)
+
+/**
+ * SexySpellBackendInterface:
+ * @parent_iface: The parent interface.
+ * @list_languages: Returns the languages dictionaries can be requested
+ *                  for, as a %NULL-terminated array freed with g_strfreev().
+ * @request_dict: Loads the dictionary for a language, or returns %NULL if
+ *                there is none. Every call returns a new dictionary.
+ * @free_dict: Frees a dictionary returned by @request_dict.
+ * @describe_dict: Returns the language of a dictionary. Tags that resolve
+ *                 to the same dictionary must give the same language.
+ * @check: Returns %TRUE if a word is spelled correctly. @length is in
+ *         bytes, or -1 if the word is nul-terminated.
+ * @suggest: Returns corrections for a misspelled word, as a
+ *           %NULL-terminated array freed with g_strfreev().
+ * @add_to_personal: Accepts a word from now on, and remembers it if the
+ *                   backend can.
+ * @add_to_session: Accepts a word for as long as the dictionary lives.
+ * @store_replacement: Tells the dictionary which correction was picked
+ *                     for a word. May be %NULL.
+ *
+ * The functions a dictionary backend implements. Dictionaries are opaque
+ * pointers to the library. All functions may be called from any thread,
+ * but a dictionary is only used by one thread at a time.
+ *
+ * Since: 1.2
+ */
+struct _SexySpellBackendInterface
+{
+	GTypeInterface parent_iface;
+
+	gchar **      (*list_languages)    (SexySpellBackend *backend);
+	gpointer      (*request_dict)      (SexySpellBackend *backend, const gchar *lang);
+	void          (*free_dict)         (SexySpellBackend *backend, gpointer dict);
+	const gchar * (*describe_dict)     (SexySpellBackend *backend, gpointer dict);
+	gboolean      (*check)             (SexySpellBackend *backend, gpointer dict,
+	                                    const gchar *word, gssize length);
+	gchar **      (*suggest)           (SexySpellBackend *backend, gpointer dict,
+	                                    const gchar *word, gssize length);
+	void          (*add_to_personal)   (SexySpellBackend *backend, gpointer dict, const gchar *word);
+	void          (*add_to_session)    (SexySpellBackend *backend, gpointer dict, const gchar *word);
+	void          (*store_replacement) (SexySpellBackend *backend, gpointer dict,
+	                                    const gchar *misspelled, const gchar *correction);
+};
+
+SexySpellBackend* sexy_spell_backend_get_default(void);
+
+G_END_DECLS
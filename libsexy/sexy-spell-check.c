@@ -0,0 +1,300 @@
+/*
+ * @file libsexy/sexy-spell-check.c Command-line spell checker
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+/*
+ * Checks files, or the standard input, with a SexySpellChecker and
+ * prints every misspelled word as
+ *
+ *   FILE:LINE:COLUMN: WORD
+ *
+ * where LINE and COLUMN count from 1 and COLUMN is in bytes. Lines are
+ * read in batches and checked with sexy_spell_checker_check_batch(), so
+ * -j sets the number of threads even for a single file, and memory does
+ * not grow with the size of the input.
+ *
+ * With -w, words are checked against a plain word list, loaded for every
+ * -l language, instead of the installed dictionaries.
+ *
+ * Exits with 0 if no word is misspelled, 1 if some are and 2 on errors.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "sexy-spell-checker.h"
+#include "sexy-wordlist-backend.h"
+
+#define BATCH_LINES 4096
+#define BATCH_BYTES (4 * 1024 * 1024)
+
+typedef struct
+{
+	SexySpellChecker *checker;
+	const gchar *name;
+
+	/* The lines read but not checked yet */
+	GPtrArray *lines;
+	guint64 first_line;
+	gsize batch_bytes;
+
+	guint n_files;
+	guint64 n_lines;
+	guint64 n_bytes;
+	guint64 n_misspelled;
+} Check;
+
+static gchar **languages = NULL;
+static gchar *wordlist = NULL;
+static gint n_jobs = 0;
+static gboolean show_stats = FALSE;
+
+static GOptionEntry entries[] = {
+	{ "language", 'l', 0, G_OPTION_ARG_STRING_ARRAY, &languages, "Check with LANG, may be repeated", "LANG" },
+	{ "wordlist", 'w', 0, G_OPTION_ARG_FILENAME, &wordlist, "Check against the words in FILE, one per line", "FILE" },
+	{ "jobs", 'j', 0, G_OPTION_ARG_INT, &n_jobs, "Use N threads, 0 for one per processor", "N" },
+	{ "stats", 's', 0, G_OPTION_ARG_NONE, &show_stats, "Print the throughput to standard error", NULL },
+	{ NULL }
+};
+
+static gboolean
+flush_batch (Check *check, GError **error)
+{
+	GPtrArray *results;
+	guint i, j;
+
+	if (check->lines->len == 0)
+		return TRUE;
+
+	results = sexy_spell_checker_check_batch (check->checker, (const gchar * const *) check->lines->pdata,
+	                                          check->lines->len, NULL, error);
+	if (results == NULL)
+		return FALSE;
+
+	for (i = 0; i < results->len; i++)
+	{
+		const gchar *line = g_ptr_array_index (check->lines, i);
+		GArray *spans = g_ptr_array_index (results, i);
+
+		for (j = 0; j < spans->len; j++)
+		{
+			SexySpellSpan *span = &g_array_index (spans, SexySpellSpan, j);
+
+			g_print ("%s:%" G_GUINT64_FORMAT ":%d: %.*s\n", check->name, check->first_line + i,
+			         span->start + 1, span->end - span->start, line + span->start);
+		}
+		check->n_misspelled += spans->len;
+	}
+
+	check->first_line += check->lines->len;
+	check->batch_bytes = 0;
+	g_ptr_array_set_size (check->lines, 0);
+	g_ptr_array_unref (results);
+
+	return TRUE;
+}
+
+/* Replaces bytes that are not UTF-8 with '?', so columns stay right */
+static void
+make_valid (gchar *line, gsize length)
+{
+	gchar *p = line;
+	const gchar *end;
+
+	while (!g_utf8_validate (p, length - (p - line), &end))
+	{
+		p = (gchar *) end;
+		*p++ = '?';
+	}
+}
+
+static gboolean
+check_channel (Check *check, GIOChannel *channel, GError **error)
+{
+	GString *line;
+	GIOStatus status;
+	gsize terminator;
+
+	if (g_io_channel_set_encoding (channel, NULL, error) != G_IO_STATUS_NORMAL)
+		return FALSE;
+
+	line = g_string_new (NULL);
+	check->first_line = 1;
+	check->n_files++;
+
+	while ((status = g_io_channel_read_line_string (channel, line, &terminator, error)) == G_IO_STATUS_NORMAL)
+	{
+		check->n_bytes += line->len;
+		check->n_lines++;
+
+		g_string_truncate (line, terminator);
+		make_valid (line->str, line->len);
+		check->batch_bytes += line->len;
+		g_ptr_array_add (check->lines, g_strndup (line->str, line->len));
+
+		if (check->lines->len >= BATCH_LINES || check->batch_bytes >= BATCH_BYTES)
+		{
+			if (!flush_batch (check, error))
+			{
+				status = G_IO_STATUS_ERROR;
+				break;
+			}
+		}
+	}
+	g_string_free (line, TRUE);
+
+	if (status == G_IO_STATUS_ERROR)
+		return FALSE;
+
+	return flush_batch (check, error);
+}
+
+static gboolean
+check_file (Check *check, const gchar *path, GError **error)
+{
+	GIOChannel *channel;
+	gboolean ret;
+
+	check->name = path;
+	if (g_strcmp0 (path, "-") == 0)
+		channel = g_io_channel_unix_new (fileno (stdin));
+	else
+	{
+		channel = g_io_channel_new_file (path, "r", error);
+		if (channel == NULL)
+			return FALSE;
+	}
+
+	ret = check_channel (check, channel, error);
+	g_io_channel_unref (channel);
+
+	return ret;
+}
+
+int
+main (int argc, char **argv)
+{
+	GOptionContext *context;
+	Check check = { 0, };
+	gboolean failed = FALSE;
+	gint64 start, elapsed;
+	GError *error = NULL;
+	gint i;
+
+	context = g_option_context_new ("[FILE...] - check the spelling of text files");
+	g_option_context_set_summary (context, "Prints every misspelled word as FILE:LINE:COLUMN: WORD. "
+	                                       "With no FILE, or when FILE is -, standard input is read.\n\n"
+	                                       "Exits with 0 if no word is misspelled, 1 if some are and 2 on errors.");
+	g_option_context_add_main_entries (context, entries, NULL);
+	if (!g_option_context_parse (context, &argc, &argv, &error))
+	{
+		g_printerr ("%s: %s\n", g_get_prgname (), error->message);
+		return 2;
+	}
+	g_option_context_free (context);
+
+	if (wordlist != NULL)
+	{
+		SexyWordlistBackend *backend = sexy_wordlist_backend_new ();
+
+		/* The word list stands in for every language asked for */
+		if (languages == NULL)
+		{
+			languages = g_new0 (gchar *, 2);
+			languages[0] = g_strdup ("en");
+		}
+
+		for (i = 0; languages[i]; i++)
+		{
+			if (!sexy_wordlist_backend_load_file (backend, languages[i], wordlist, &error))
+			{
+				g_printerr ("%s: %s: %s\n", g_get_prgname (), wordlist, error->message);
+				return 2;
+			}
+		}
+
+		check.checker = sexy_spell_checker_new_with_backend (SEXY_SPELL_BACKEND(backend));
+		g_object_unref (backend);
+	}
+	else
+	{
+		check.checker = sexy_spell_checker_new ();
+	}
+	check.lines = g_ptr_array_new_with_free_func (g_free);
+	sexy_spell_checker_set_batch_threads (check.checker, MAX(n_jobs, 0));
+
+	if (languages != NULL)
+	{
+		GSList *langs = NULL;
+
+		for (i = 0; languages[i]; i++)
+			langs = g_slist_append (langs, languages[i]);
+
+		if (!sexy_spell_checker_set_active_languages (check.checker, langs, &error))
+		{
+			g_printerr ("%s: %s\n", g_get_prgname (), error->message);
+			return 2;
+		}
+		g_slist_free (langs);
+	}
+	else
+	{
+		sexy_spell_checker_activate_default_languages (check.checker);
+	}
+
+	start = g_get_monotonic_time ();
+
+	for (i = 1; i < MAX(argc, 2); i++)
+	{
+		if (!check_file (&check, i < argc ? argv[i] : "-", &error))
+		{
+			g_printerr ("%s: %s: %s\n", g_get_prgname (), check.name, error->message);
+			g_clear_error (&error);
+			g_ptr_array_set_size (check.lines, 0);
+			failed = TRUE;
+		}
+	}
+
+	elapsed = MAX(g_get_monotonic_time () - start, 1);
+
+	if (show_stats)
+	{
+		gdouble seconds = (gdouble) elapsed / G_USEC_PER_SEC;
+
+		g_printerr ("files:                 %u\n", check.n_files);
+		g_printerr ("lines:                 %" G_GUINT64_FORMAT "\n", check.n_lines);
+		g_printerr ("bytes:                 %" G_GUINT64_FORMAT "\n", check.n_bytes);
+		g_printerr ("misspelled:            %" G_GUINT64_FORMAT "\n", check.n_misspelled);
+		g_printerr ("time:                  %.3f s\n", seconds);
+		g_printerr ("throughput:            %.2f MB/s, %.0f lines/s\n",
+		           check.n_bytes / seconds / (1024 * 1024), check.n_lines / seconds);
+	}
+
+	g_ptr_array_unref (check.lines);
+	g_object_unref (check.checker);
+	g_strfreev (languages);
+	g_free (wordlist);
+
+	if (failed)
+		return 2;
+	return check.n_misspelled > 0 ? 1 : 0;
+}
@@ -0,0 +1,40 @@
+/*
+ * @file libsexy/sexy-spell-checker-private.h SexySpellChecker internals
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+#pragma once
+
+#include "sexy-spell-checker.h"
+#include "sexy-dict-registry.h"
+#include "sexy-skip-rules.h"
+
+G_BEGIN_DECLS
+
+/* Default of SexySpellChecker:cache-size, and so of SexySpellEntry's */
+#define SEXY_SPELL_CHECKER_DEFAULT_CACHE_SIZE 1024
+
+GSList *sexy_spell_checker_get_dicts (SexySpellChecker *checker);
+SexyDict *sexy_spell_checker_get_dict (SexySpellChecker *checker, const gchar *lang);
+guint sexy_spell_checker_get_generation (SexySpellChecker *checker);
+gboolean sexy_spell_checker_cache_lookup (SexySpellChecker *checker, const gchar *word, gboolean *misspelled);
+void sexy_spell_checker_cache_insert (SexySpellChecker *checker, const gchar *word, gboolean misspelled);
+gboolean sexy_spell_checker_lookup (SexySpellChecker *checker, const gchar *word);
+gboolean sexy_spell_checker_skips (SexySpellChecker *checker, const gchar *text, gint text_len,
+                                   gint start, gint end, SexySkipCache *cache);
+
+G_END_DECLS
@@ -0,0 +1,1716 @@
+/*
+ * @file libsexy/sexy-spell-checker.c Spell checker without a widget
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <string.h>
+
+#include <glib/gi18n.h>
+
+#include "sexy-spell-checker-private.h"
+#include "sexy-dict-registry.h"
+#include "sexy-skip-rules.h"
+#include "sexy-tokenizer.h"
+#include "sexy-trace.h"
+
+/**
+ * SECTION: sexy-spell-checker
+ * @short_description: Spell checking without a widget
+ * @title: SpellChecker
+ * @see_also: #SexySpellEntry
+ * @include: libsexy3/sexy-spell-checker.h
+ *
+ * Checks words and whole texts against a set of active dictionaries,
+ * without needing a display. Every #SexySpellEntry checks through one,
+ * see sexy_spell_entry_get_checker().
+ *
+ * A checker may be used from any thread, but only from one at a time.
+ * Checkers on different threads may have the same languages active.
+ */
+
+struct _SexySpellChecker
+{
+	GObject parent_instance;
+
+	SexySpellBackend *backend;
+	GHashTable *dict_hash;
+	GSList *dict_list;
+
+	/* Words matching these are never looked up, see sexy-skip-rules.c */
+	SexySkipRules skip_rules;
+	GPtrArray *skip_patterns;
+
+	/* Dictionary verdicts of recently checked words, in two generations.
+	 * They are dropped whenever the active dictionaries or their word
+	 * lists change, see sexy_spell_checker_cache_lookup(). */
+	GHashTable *verdicts;
+	GHashTable *old_verdicts;
+	guint cache_size;
+	guint dict_generation;
+	guint verdict_generation;
+	guint cache_hits;
+	guint cache_misses;
+
+	/* Threads used by sexy_spell_checker_check_batch(), 0 for one per core */
+	guint batch_threads;
+
+	/* Reused by sexy_spell_checker_check_text() */
+	SexyWordList *words;
+	GString *scratch;
+};
+
+G_DEFINE_TYPE (SexySpellChecker, sexy_spell_checker, G_TYPE_OBJECT)
+
+enum
+{
+	CHANGED,
+	LAST_SIGNAL
+};
+static guint signals[LAST_SIGNAL] = {0};
+
+enum
+{
+	PROP_0,
+	PROP_BACKEND,
+	PROP_CACHE_SIZE,
+	PROP_BATCH_THREADS,
+	N_PROPERTIES
+};
+
+GQuark
+sexy_spell_error_quark(void)
+{
+	static GQuark q = 0;
+	if (q == 0)
+		q = g_quark_from_static_string ("sexy-spell-error-quark");
+	return q;
+}
+
+static void
+sexy_spell_checker_set_property (GObject *obj, guint prop_id, const GValue *value, GParamSpec *pspec)
+{
+	SexySpellChecker *checker = SEXY_SPELL_CHECKER(obj);
+
+	switch (prop_id)
+	{
+		case PROP_BACKEND:
+			checker->backend = g_value_dup_object (value);
+			if (checker->backend == NULL)
+				checker->backend = g_object_ref (sexy_spell_backend_get_default ());
+			break;
+		case PROP_CACHE_SIZE:
+			sexy_spell_checker_set_cache_size (checker, g_value_get_uint(value));
+			break;
+		case PROP_BATCH_THREADS:
+			sexy_spell_checker_set_batch_threads (checker, g_value_get_uint(value));
+			break;
+		default:
+			G_OBJECT_WARN_INVALID_PROPERTY_ID (obj, prop_id, pspec);
+			break;
+	}
+}
+
+static void
+sexy_spell_checker_get_property (GObject *obj, guint prop_id, GValue *value, GParamSpec *pspec)
+{
+	SexySpellChecker *checker = SEXY_SPELL_CHECKER(obj);
+
+	switch (prop_id)
+	{
+		case PROP_BACKEND:
+			g_value_set_object (value, checker->backend);
+			break;
+		case PROP_CACHE_SIZE:
+			g_value_set_uint (value, sexy_spell_checker_get_cache_size (checker));
+			break;
+		case PROP_BATCH_THREADS:
+			g_value_set_uint (value, sexy_spell_checker_get_batch_threads (checker));
+			break;
+		default:
+			G_OBJECT_WARN_INVALID_PROPERTY_ID (obj, prop_id, pspec);
+			break;
+	}
+}
+
+static void
+sexy_spell_checker_finalize (GObject *obj)
+{
+	SexySpellChecker *checker = SEXY_SPELL_CHECKER(obj);
+
+	g_hash_table_destroy (checker->dict_hash);
+	g_slist_free_full (checker->dict_list, (GDestroyNotify) sexy_dict_registry_release);
+	g_ptr_array_unref (checker->skip_patterns);
+	g_hash_table_destroy (checker->verdicts);
+	g_hash_table_destroy (checker->old_verdicts);
+	sexy_word_list_free (checker->words);
+	g_string_free (checker->scratch, TRUE);
+	g_object_unref (checker->backend);
+
+	G_OBJECT_CLASS(sexy_spell_checker_parent_class)->finalize (obj);
+}
+
+static void
+sexy_spell_checker_class_init (SexySpellCheckerClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS(klass);
+
+	object_class->set_property = sexy_spell_checker_set_property;
+	object_class->get_property = sexy_spell_checker_get_property;
+	object_class->finalize = sexy_spell_checker_finalize;
+
+	/**
+	 * SexySpellChecker::changed:
+	 * @checker: The checker on which the signal is emitted.
+	 *
+	 * The ::changed signal is emitted when earlier results may no longer
+	 * be right, because the active languages, their word lists or the
+	 * skip rules changed.
+	 *
+	 * Since: 1.2
+	 */
+	signals[CHANGED] = g_signal_new ("changed",
+					 G_TYPE_FROM_CLASS(object_class),
+					 G_SIGNAL_RUN_LAST,
+					 0, NULL, NULL, NULL,
+					 G_TYPE_NONE, 0);
+
+	/**
+	 * SexySpellChecker:backend:
+	 *
+	 * The backend dictionaries are loaded from. Setting it to %NULL at
+	 * construction uses sexy_spell_backend_get_default().
+	 *
+	 * Since: 1.2
+	 */
+	g_object_class_install_property (object_class, PROP_BACKEND,
+							g_param_spec_object ("backend", "Backend",
+										"Backend dictionaries are loaded from",
+										SEXY_TYPE_SPELL_BACKEND,
+										G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+
+	/**
+	 * SexySpellChecker:cache-size:
+	 *
+	 * The number of dictionary verdicts to remember, so that words seen
+	 * again are not looked up. 0 disables the cache.
+	 *
+	 * Since: 1.2
+	 */
+	g_object_class_install_property (object_class, PROP_CACHE_SIZE,
+							g_param_spec_uint ("cache-size", "Cache Size",
+										"Number of dictionary verdicts to remember",
+										0, G_MAXUINT, SEXY_SPELL_CHECKER_DEFAULT_CACHE_SIZE, G_PARAM_READWRITE));
+
+	/**
+	 * SexySpellChecker:batch-threads:
+	 *
+	 * The largest number of threads sexy_spell_checker_check_batch()
+	 * spreads texts over. 0 uses one per processor.
+	 *
+	 * Since: 1.2
+	 */
+	g_object_class_install_property (object_class, PROP_BATCH_THREADS,
+							g_param_spec_uint ("batch-threads", "Batch Threads",
+										"Largest number of threads used to check a batch",
+										0, G_MAXUINT, 0, G_PARAM_READWRITE));
+}
+
+static void
+sexy_spell_checker_init (SexySpellChecker *checker)
+{
+	checker->dict_hash = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	checker->skip_rules = SEXY_SKIP_DEFAULT;
+	checker->skip_patterns = g_ptr_array_new_with_free_func ((GDestroyNotify) g_regex_unref);
+	checker->verdicts = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	checker->old_verdicts = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	checker->cache_size = SEXY_SPELL_CHECKER_DEFAULT_CACHE_SIZE;
+	checker->words = sexy_word_list_new ();
+	checker->scratch = g_string_sized_new (64);
+}
+
+/**
+ * sexy_spell_checker_new:
+ *
+ * Creates a new spell checker without any active language.
+ *
+ * Returns: (transfer full): a new #SexySpellChecker.
+ *
+ * Since: 1.2
+ */
+SexySpellChecker *
+sexy_spell_checker_new(void)
+{
+	return g_object_new (SEXY_TYPE_SPELL_CHECKER, NULL);
+}
+
+/**
+ * sexy_spell_checker_new_with_backend:
+ * @backend: (nullable): The #SexySpellBackend to load dictionaries from,
+ *           or %NULL for the default one.
+ *
+ * Creates a new spell checker without any active language, which checks
+ * words against dictionaries of @backend.
+ *
+ * Returns: (transfer full): a new #SexySpellChecker.
+ *
+ * Since: 1.2
+ */
+SexySpellChecker *
+sexy_spell_checker_new_with_backend(SexySpellBackend *backend)
+{
+	g_return_val_if_fail (backend == NULL || SEXY_IS_SPELL_BACKEND(backend), NULL);
+
+	return g_object_new (SEXY_TYPE_SPELL_CHECKER, "backend", backend, NULL);
+}
+
+/**
+ * sexy_spell_checker_get_backend:
+ * @checker: A #SexySpellChecker.
+ *
+ * Gets the backend @checker loads dictionaries from.
+ *
+ * Returns: (transfer none): the #SexySpellBackend of @checker.
+ *
+ * Since: 1.2
+ */
+SexySpellBackend *
+sexy_spell_checker_get_backend(SexySpellChecker *checker)
+{
+	g_return_val_if_fail (SEXY_IS_SPELL_CHECKER(checker), NULL);
+
+	return checker->backend;
+}
+
+static void
+invalidate_verdicts (SexySpellChecker *checker)
+{
+	checker->dict_generation++;
+}
+
+static void
+install_dict (SexySpellChecker *checker, SexyDict *dict)
+{
+	/* Different language codes can resolve to the same shared dictionary */
+	if (g_slist_find (checker->dict_list, dict))
+	{
+		sexy_dict_registry_release (dict);
+		return;
+	}
+
+	checker->dict_list = g_slist_append (checker->dict_list, (gpointer) dict);
+	g_hash_table_insert (checker->dict_hash, sexy_dict_registry_get_lang (dict), (gpointer) dict);
+	invalidate_verdicts (checker);
+}
+
+static void
+release_dicts (SexySpellChecker *checker)
+{
+	g_slist_free_full (checker->dict_list, (GDestroyNotify) sexy_dict_registry_release);
+	g_hash_table_remove_all (checker->dict_hash);
+	checker->dict_list = NULL;
+	invalidate_verdicts (checker);
+}
+
+static gboolean
+activate_language_internal (SexySpellChecker *checker, const gchar *lang, GError **error)
+{
+	SexyDict *dict;
+
+	if (g_hash_table_lookup (checker->dict_hash, lang))
+		return TRUE;
+
+	dict = sexy_dict_registry_request (checker->backend, lang);
+
+	if (!dict)
+	{
+		g_set_error (error, SEXY_SPELL_ERROR, SEXY_SPELL_ERROR_BACKEND, _("no dictionary for language: %s"), lang);
+		return FALSE;
+	}
+
+	install_dict (checker, dict);
+
+	return TRUE;
+}
+
+/**
+ * sexy_spell_checker_get_languages:
+ * @checker: A #SexySpellChecker.
+ *
+ * Retrieve a list of language codes for which dictionaries are available.
+ *
+ * Returns: (transfer full) (element-type utf8): a new #GSList, or %NULL
+ *          on error. Should be freed with g_slist_free_full() and g_free().
+ *
+ * Since: 1.2
+ */
+GSList *
+sexy_spell_checker_get_languages(SexySpellChecker *checker)
+{
+	g_return_val_if_fail (SEXY_IS_SPELL_CHECKER(checker), NULL);
+
+	return sexy_dict_registry_list_languages (checker->backend);
+}
+
+/**
+ * sexy_spell_checker_language_is_active:
+ * @checker: A #SexySpellChecker.
+ * @lang: The language to use, in a form enchant understands.
+ *
+ * Determine if a given language is currently active.
+ *
+ * Returns: %TRUE if the language is active.
+ *
+ * Since: 1.2
+ */
+gboolean
+sexy_spell_checker_language_is_active(SexySpellChecker *checker, const gchar *lang)
+{
+	g_return_val_if_fail (SEXY_IS_SPELL_CHECKER(checker), FALSE);
+
+	return g_hash_table_lookup (checker->dict_hash, lang) != NULL;
+}
+
+/**
+ * sexy_spell_checker_activate_language:
+ * @checker: A #SexySpellChecker.
+ * @lang: The language to use in a form Enchant understands. Typically either
+ *        a two letter language code or a locale code in the form xx_XX.
+ * @error: Return location for error.
+ *
+ * Activate spell checking for the language specifed.
+ *
+ * Returns: %FALSE if there was an error.
+ *
+ * Since: 1.2
+ */
+gboolean
+sexy_spell_checker_activate_language(SexySpellChecker *checker, const gchar *lang, GError **error)
+{
+	g_return_val_if_fail (SEXY_IS_SPELL_CHECKER(checker), FALSE);
+	g_return_val_if_fail (lang != NULL && *lang != '\0', FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	if (!activate_language_internal (checker, lang, error))
+		return FALSE;
+
+	g_signal_emit (checker, signals[CHANGED], 0);
+	return TRUE;
+}
+
+/**
+ * sexy_spell_checker_deactivate_language:
+ * @checker: A #SexySpellChecker.
+ * @lang: (nullable): The language in a form Enchant understands, or
+ *        %NULL to deactivate all languages.
+ *
+ * Deactivate spell checking for the language specifed.
+ *
+ * Since: 1.2
+ */
+void
+sexy_spell_checker_deactivate_language(SexySpellChecker *checker, const gchar *lang)
+{
+	g_return_if_fail (SEXY_IS_SPELL_CHECKER(checker));
+
+	if (!checker->dict_list)
+		return;
+
+	if (lang)
+	{
+		SexyDict *dict;
+
+		dict = g_hash_table_lookup (checker->dict_hash, lang);
+		if (!dict)
+			return;
+		sexy_dict_registry_release (dict);
+		checker->dict_list = g_slist_remove (checker->dict_list, dict);
+		g_hash_table_remove (checker->dict_hash, lang);
+		invalidate_verdicts (checker);
+	}
+	else
+	{
+		/* deactivate all */
+		release_dicts (checker);
+	}
+
+	g_signal_emit (checker, signals[CHANGED], 0);
+}
+
+/**
+ * sexy_spell_checker_set_active_languages:
+ * @checker: A #SexySpellChecker.
+ * @langs: (element-type utf8): A list of language codes to activate,
+ *         in a form Enchant understands. Typically either a two letter
+ *         language code or a locale code in the form xx_XX.
+ * @error: Return location for error.
+ *
+ * Activate spell checking for only the languages specified.
+ *
+ * Returns: %FALSE if there was an error.
+ *
+ * Since: 1.2
+ */
+gboolean
+sexy_spell_checker_set_active_languages(SexySpellChecker *checker, GSList *langs, GError **error)
+{
+	gboolean ret = TRUE;
+	GSList *li;
+
+	g_return_val_if_fail (SEXY_IS_SPELL_CHECKER(checker), FALSE);
+	g_return_val_if_fail (langs != NULL, FALSE);
+
+	/* deactivate all languages first */
+	release_dicts (checker);
+
+	for (li = langs; li && ret; li = g_slist_next (li))
+		ret = activate_language_internal (checker, (const gchar*)li->data, error);
+
+	g_signal_emit (checker, signals[CHANGED], 0);
+	return ret;
+}
+
+typedef struct
+{
+	GSList *langs;
+	GSList *dicts;
+	gboolean replace;
+} LoadDictsData;
+
+static void
+load_dicts_data_free(LoadDictsData *data)
+{
+	g_slist_free_full (data->langs, g_free);
+	g_slist_free_full (data->dicts, (GDestroyNotify) sexy_dict_registry_release);
+	g_free (data);
+}
+
+static void
+load_dicts_thread(GTask *task, gpointer source_object, gpointer task_data, GCancellable *cancellable)
+{
+	SexySpellChecker *checker = SEXY_SPELL_CHECKER(source_object);
+	LoadDictsData *data = task_data;
+	GSList *li;
+
+	for (li = data->langs; li; li = g_slist_next (li))
+	{
+		const gchar *lang = li->data;
+		SexyDict *dict;
+
+		if (g_task_return_error_if_cancelled (task))
+			return;
+
+		dict = sexy_dict_registry_request (checker->backend, lang);
+		if (!dict)
+		{
+			g_task_return_new_error (task, SEXY_SPELL_ERROR, SEXY_SPELL_ERROR_BACKEND,
+			                         _("no dictionary for language: %s"), lang);
+			return;
+		}
+		data->dicts = g_slist_append (data->dicts, dict);
+	}
+
+	g_task_return_boolean (task, TRUE);
+}
+
+static void
+load_dicts_cb(GObject *source_object, GAsyncResult *result, gpointer user_data)
+{
+	SexySpellChecker *checker = SEXY_SPELL_CHECKER(source_object);
+	GTask *task = G_TASK(user_data);
+	LoadDictsData *data = g_task_get_task_data (G_TASK(result));
+	GError *error = NULL;
+	GSList *li;
+
+	if (!g_task_propagate_boolean (G_TASK(result), &error))
+	{
+		g_task_return_error (task, error);
+		g_object_unref (task);
+		return;
+	}
+
+	if (g_task_return_error_if_cancelled (task))
+	{
+		g_object_unref (task);
+		return;
+	}
+
+	/* Everything is loaded, swap the dictionaries in at once */
+	if (data->replace)
+		release_dicts (checker);
+
+	for (li = data->dicts; li; li = g_slist_next (li))
+		install_dict (checker, li->data);
+	g_slist_free (data->dicts);
+	data->dicts = NULL;
+
+	g_signal_emit (checker, signals[CHANGED], 0);
+
+	g_task_return_boolean (task, TRUE);
+	g_object_unref (task);
+}
+
+static void
+load_dicts_async(SexySpellChecker *checker, GSList *langs, gboolean replace, GCancellable *cancellable,
+                 GAsyncReadyCallback callback, gpointer user_data, gpointer source_tag)
+{
+	GTask *task, *load_task;
+	LoadDictsData *data;
+
+	task = g_task_new (checker, cancellable, callback, user_data);
+	g_task_set_source_tag (task, source_tag);
+
+	data = g_new0 (LoadDictsData, 1);
+	data->langs = langs;
+	data->replace = replace;
+
+	/* The loading task finishes in load_dicts_cb(), which installs the
+	 * dictionaries before @task reports back to the caller. */
+	load_task = g_task_new (checker, cancellable, load_dicts_cb, task);
+	g_task_set_task_data (load_task, data, (GDestroyNotify) load_dicts_data_free);
+	g_task_run_in_thread (load_task, load_dicts_thread);
+	g_object_unref (load_task);
+}
+
+/**
+ * sexy_spell_checker_activate_language_async:
+ * @checker: A #SexySpellChecker.
+ * @lang: The language to use in a form Enchant understands. Typically either
+ *        a two letter language code or a locale code in the form xx_XX.
+ * @cancellable: (nullable): A #GCancellable.
+ * @callback: Called when the language is active.
+ * @user_data: Data passed to @callback.
+ *
+ * Asynchronous version of sexy_spell_checker_activate_language(). The
+ * dictionary is loaded in a worker thread, the checker keeps using the
+ * currently active languages until it is ready.
+ *
+ * Since: 1.2
+ */
+void
+sexy_spell_checker_activate_language_async(SexySpellChecker *checker, const gchar *lang, GCancellable *cancellable,
+                                           GAsyncReadyCallback callback, gpointer user_data)
+{
+	g_return_if_fail (SEXY_IS_SPELL_CHECKER(checker));
+	g_return_if_fail (lang != NULL && *lang != '\0');
+
+	load_dicts_async (checker, g_slist_append (NULL, g_strdup (lang)), FALSE, cancellable,
+	                  callback, user_data, sexy_spell_checker_activate_language_async);
+}
+
+/**
+ * sexy_spell_checker_activate_language_finish:
+ * @checker: A #SexySpellChecker.
+ * @result: The #GAsyncResult passed to the callback.
+ * @error: Return location for error.
+ *
+ * Finishes sexy_spell_checker_activate_language_async().
+ *
+ * Returns: %FALSE if there was an error.
+ * Since: 1.2
+ */
+gboolean
+sexy_spell_checker_activate_language_finish(SexySpellChecker *checker, GAsyncResult *result, GError **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, checker), FALSE);
+
+	return g_task_propagate_boolean (G_TASK(result), error);
+}
+
+/**
+ * sexy_spell_checker_set_active_languages_async:
+ * @checker: A #SexySpellChecker.
+ * @langs: (element-type utf8): A list of language codes to activate,
+ *         in a form Enchant understands. Typically either a two letter
+ *         language code or a locale code in the form xx_XX.
+ * @cancellable: (nullable): A #GCancellable.
+ * @callback: Called when the languages are active.
+ * @user_data: Data passed to @callback.
+ *
+ * Asynchronous version of sexy_spell_checker_set_active_languages(). All
+ * dictionaries are loaded in a worker thread and replace the active ones
+ * in one go. If any of them fails to load the active languages are left
+ * untouched.
+ *
+ * Since: 1.2
+ */
+void
+sexy_spell_checker_set_active_languages_async(SexySpellChecker *checker, GSList *langs, GCancellable *cancellable,
+                                              GAsyncReadyCallback callback, gpointer user_data)
+{
+	GSList *copy = NULL, *li;
+
+	g_return_if_fail (SEXY_IS_SPELL_CHECKER(checker));
+	g_return_if_fail (langs != NULL);
+
+	for (li = langs; li; li = g_slist_next (li))
+		copy = g_slist_prepend (copy, g_strdup (li->data));
+
+	load_dicts_async (checker, g_slist_reverse (copy), TRUE, cancellable,
+	                  callback, user_data, sexy_spell_checker_set_active_languages_async);
+}
+
+/**
+ * sexy_spell_checker_set_active_languages_finish:
+ * @checker: A #SexySpellChecker.
+ * @result: The #GAsyncResult passed to the callback.
+ * @error: Return location for error.
+ *
+ * Finishes sexy_spell_checker_set_active_languages_async().
+ *
+ * Returns: %FALSE if there was an error.
+ * Since: 1.2
+ */
+gboolean
+sexy_spell_checker_set_active_languages_finish(SexySpellChecker *checker, GAsyncResult *result, GError **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, checker), FALSE);
+
+	return g_task_propagate_boolean (G_TASK(result), error);
+}
+
+/**
+ * sexy_spell_checker_get_active_languages:
+ * @checker: A #SexySpellChecker.
+ *
+ * Retrieve a list of the currently active languages.
+ *
+ * Returns: (transfer full) (element-type utf8): A list of language codes ("en", "de_DE", etc).
+ *          The list should be freed with g_slist_free_full () and g_free().
+ *
+ * Since: 1.2
+ */
+GSList *
+sexy_spell_checker_get_active_languages(SexySpellChecker *checker)
+{
+	GSList *ret = NULL, *li;
+
+	g_return_val_if_fail (SEXY_IS_SPELL_CHECKER(checker), NULL);
+
+	for (li = checker->dict_list; li; li = g_slist_next (li))
+		ret = g_slist_append (ret, sexy_dict_registry_get_lang (li->data));
+	return ret;
+}
+
+static gboolean
+enchant_has_lang(const gchar *lang, GSList *langs)
+{
+	GSList *i;
+	for (i = langs; i; i = g_slist_next(i))
+	{
+		if (strcmp(lang, i->data) == 0)
+			return TRUE;
+	}
+	return FALSE;
+}
+
+static GSList *
+get_default_spell_languages (void)
+{
+	const gchar* const *langs = g_get_language_names ();
+	GSList *lang_list = NULL;
+	char *last = NULL;
+	char *p;
+	int i;
+
+	if (langs != NULL)
+	{
+		for (i = 0; langs[i]; i++)
+		{
+			if (g_ascii_strncasecmp (langs[i], "C", 1) != 0 && strlen (langs[i]) >= 2)
+			{
+				/* Avoid duplicates, "en" and "en_US" for example. */
+				if (!last || !g_str_has_prefix (langs[i], last))
+				{
+					if (last != NULL)
+						g_free(last);
+
+					/* ignore .utf8 */
+					if ((p = strchr (langs[i], '.')))
+						*p='\0';
+
+					last = g_strndup (langs[i], 2);
+
+					lang_list = g_slist_append (lang_list, (char*)langs[i]);
+				}
+			}
+		}
+		if (last != NULL)
+			g_free(last);
+	}
+
+	return lang_list;
+}
+
+/**
+ * sexy_spell_checker_activate_default_languages:
+ * @checker: A #SexySpellChecker.
+ *
+ * Activate spell checking for languages specified in the $LANG
+ * or $LANGUAGE environment variables. If none is found it defaults to "en".
+ *
+ * Since: 1.2
+ */
+void
+sexy_spell_checker_activate_default_languages(SexySpellChecker *checker)
+{
+	GSList *enchant_langs, *langs, *lang_item;
+	char *lang;
+
+	g_return_if_fail (SEXY_IS_SPELL_CHECKER(checker));
+
+	enchant_langs = sexy_spell_checker_get_languages (checker);
+	langs = get_default_spell_languages();
+	if (langs)
+	{
+		lang_item = langs;
+		while (lang_item != NULL)
+		{
+			lang = (char*)lang_item->data;
+			if (enchant_has_lang (lang, enchant_langs))
+			{
+				activate_language_internal (checker, lang, NULL);
+			}
+			lang_item = g_slist_next(lang_item);
+		}
+		g_slist_free (langs);
+	}
+	g_slist_free_full (enchant_langs, g_free);
+
+	/* If we don't have any languages activated, use "en" */
+	if (checker->dict_list == NULL)
+		activate_language_internal (checker, "en", NULL);
+
+	g_signal_emit (checker, signals[CHANGED], 0);
+}
+
+/**
+ * sexy_spell_checker_check_word:
+ * @checker: A #SexySpellChecker.
+ * @word: The word to check.
+ * @length: The length of @word in bytes, or -1 if it is nul-terminated.
+ *
+ * Looks a single word up in the active dictionaries. Words that do not
+ * start with a letter are never misspelled. The skip rules are not
+ * applied, since they look at the text around a word.
+ *
+ * Returns: %TRUE if none of the active dictionaries contains @word.
+ *
+ * Since: 1.2
+ */
+gboolean
+sexy_spell_checker_check_word(SexySpellChecker *checker, const gchar *word, gssize length)
+{
+	gboolean misspelled;
+
+	g_return_val_if_fail (SEXY_IS_SPELL_CHECKER(checker), FALSE);
+	g_return_val_if_fail (word != NULL, FALSE);
+
+	/* @word may be part of a longer text, so nothing past @length is read */
+	if (length >= 0)
+	{
+		g_string_truncate (checker->scratch, 0);
+		g_string_append_len (checker->scratch, word, length);
+		word = checker->scratch->str;
+	}
+
+	if (checker->dict_list == NULL || g_unichar_isalpha (g_utf8_get_char (word)) == FALSE)
+		return FALSE;
+
+	if (sexy_spell_checker_cache_lookup (checker, word, &misspelled))
+		return misspelled;
+
+	misspelled = sexy_spell_checker_lookup (checker, word);
+	sexy_spell_checker_cache_insert (checker, word, misspelled);
+	return misspelled;
+}
+
+/* Appends the misspelled words of @text to @spans */
+static void
+find_misspelled (SexySpellChecker *checker, const gchar *text, gint length, GArray *spans)
+{
+	SexyWordList *words = checker->words;
+	SexySkipCache skip_cache;
+	guint i;
+
+	if (checker->dict_list == NULL)
+		return;
+
+	sexy_word_list_clear (words);
+	sexy_tokenize (text, length, 0, length, words);
+	sexy_skip_cache_reset (&skip_cache);
+
+	for (i = 0; i < words->len; i++)
+	{
+		SexySpellSpan span = { words->starts[i], words->ends[i] };
+
+		if (sexy_spell_checker_skips (checker, text, length, span.start, span.end, &skip_cache))
+			continue;
+
+		if (sexy_spell_checker_check_word (checker, text + span.start, span.end - span.start))
+			g_array_append_val (spans, span);
+	}
+}
+
+/**
+ * sexy_spell_checker_check_text:
+ * @checker: A #SexySpellChecker.
+ * @text: The text to check.
+ * @length: The length of @text in bytes, or -1 if it is nul-terminated.
+ *
+ * Splits @text into words and checks all of them that the skip rules
+ * let through.
+ *
+ * Returns: (transfer full) (element-type SexySpellSpan): The misspelled
+ *          words in @text, in order. Free with g_array_unref().
+ *
+ * Since: 1.2
+ */
+GArray *
+sexy_spell_checker_check_text(SexySpellChecker *checker, const gchar *text, gssize length)
+{
+	GArray *spans;
+
+	g_return_val_if_fail (SEXY_IS_SPELL_CHECKER(checker), NULL);
+	g_return_val_if_fail (text != NULL, NULL);
+
+	if (length < 0)
+		length = strlen (text);
+	g_return_val_if_fail (length <= G_MAXINT, NULL);
+
+	spans = g_array_new (FALSE, FALSE, sizeof (SexySpellSpan));
+	find_misspelled (checker, text, (gint) length, spans);
+
+	return spans;
+}
+
+#define STREAM_BUFFER_SIZE 65536
+
+/* Checks a piece of a stream that starts at @offset. Bytes that are not
+ * UTF-8 separate words like spaces do. */
+static void
+check_stream_chunk (SexySpellChecker *checker, const gchar *text, gsize length, goffset offset,
+                    GArray *spans, GString *word, SexySpellStreamFunc func, gpointer user_data)
+{
+	const gchar *p = text, *end = text + length, *valid_end;
+	guint i;
+
+	while (p < end)
+	{
+		g_utf8_validate (p, end - p, &valid_end);
+
+		g_array_set_size (spans, 0);
+		find_misspelled (checker, p, (gint) (valid_end - p), spans);
+
+		for (i = 0; i < spans->len; i++)
+		{
+			SexySpellSpan *span = &g_array_index (spans, SexySpellSpan, i);
+
+			g_string_truncate (word, 0);
+			g_string_append_len (word, p + span->start, span->end - span->start);
+			func (offset + (p - text) + span->start, word->len, word->str, user_data);
+		}
+
+		p = valid_end + 1;
+	}
+}
+
+/**
+ * sexy_spell_checker_check_stream:
+ * @checker: A #SexySpellChecker.
+ * @stream: A #GInputStream of UTF-8 text.
+ * @func: (scope call): Function to call for every misspelled word.
+ * @user_data: The data to pass to @func.
+ * @cancellable: (nullable): A #GCancellable, or %NULL.
+ * @error: Return location for a #GError, or %NULL.
+ *
+ * Reads @stream to the end and calls @func for every misspelled word in
+ * it, in order, like sexy_spell_checker_check_text() would find them in
+ * the whole text. The stream is read in pieces that end between words,
+ * so only a small buffer is held however long it is. A single token
+ * longer than the buffer is split at a character boundary. Bytes that
+ * are not valid UTF-8 are treated as spaces.
+ *
+ * This blocks until @stream is read. @stream is not closed.
+ *
+ * Returns: %FALSE if reading @stream failed, and @error is set.
+ *
+ * Since: 1.2
+ */
+gboolean
+sexy_spell_checker_check_stream(SexySpellChecker *checker, GInputStream *stream,
+                                SexySpellStreamFunc func, gpointer user_data,
+                                GCancellable *cancellable, GError **error)
+{
+	gchar *buffer;
+	gsize length = 0, cut;
+	goffset offset = 0;
+	gboolean eof = FALSE;
+	GArray *spans;
+	GString *word;
+	gssize n_read;
+
+	g_return_val_if_fail (SEXY_IS_SPELL_CHECKER(checker), FALSE);
+	g_return_val_if_fail (G_IS_INPUT_STREAM(stream), FALSE);
+	g_return_val_if_fail (func != NULL, FALSE);
+
+	buffer = g_malloc (STREAM_BUFFER_SIZE);
+	spans = g_array_new (FALSE, FALSE, sizeof (SexySpellSpan));
+	word = g_string_sized_new (64);
+
+	while (!eof)
+	{
+		n_read = g_input_stream_read (stream, buffer + length, STREAM_BUFFER_SIZE - length, cancellable, error);
+		if (n_read < 0)
+			break;
+
+		eof = n_read == 0;
+		length += n_read;
+
+		/* A word or the token around it may go on in the next read, so
+		 * only check up to the last space. */
+		cut = length;
+		if (!eof)
+		{
+			while (cut > 0 && !g_ascii_isspace (buffer[cut - 1]))
+				cut--;
+
+			if (cut == 0 && length < STREAM_BUFFER_SIZE)
+				continue;
+
+			/* No space in a full buffer, cut before its last character */
+			if (cut == 0)
+			{
+				cut = length - 1;
+				while (cut > 0 && (buffer[cut] & 0xc0) == 0x80)
+					cut--;
+				if (cut == 0)
+					cut = length;
+			}
+		}
+
+		check_stream_chunk (checker, buffer, cut, offset, spans, word, func, user_data);
+
+		memmove (buffer, buffer + cut, length - cut);
+		length -= cut;
+		offset += cut;
+	}
+
+	g_string_free (word, TRUE);
+	g_array_unref (spans);
+	g_free (buffer);
+
+	return eof;
+}
+
+/* Batch checking. The texts are handed out to the workers of a shared
+ * pool in chunks, so a slow chunk does not hold the others up. Every
+ * pool thread looks words up in its own copies of the dictionaries, see
+ * sexy_dict_registry_get_thread_dict(), and these stay loaded for as
+ * long as the thread is kept around. */
+
+#define BATCH_CHUNK 64
+#define BATCH_CACHE_SIZE 65536
+
+typedef struct
+{
+	const gchar * const *texts;
+	gchar **copy;
+	gint n_texts;
+	gint next;
+
+	SexySpellBackend *backend;
+	GPtrArray *langs;
+	SexySkipRules skip_rules;
+	GPtrArray *skip_patterns;
+	GCancellable *cancellable;
+	GPtrArray *results;
+
+	/* Workers still running. The last one either wakes the caller of
+	 * sexy_spell_checker_check_batch() or returns @task. */
+	gint n_running;
+	GTask *task;
+	GMutex lock;
+	GCond done;
+} BatchJob;
+
+G_LOCK_DEFINE_STATIC (batch_pool);
+static GThreadPool *batch_pool = NULL;
+
+static void
+batch_job_free (BatchJob *job)
+{
+	g_strfreev (job->copy);
+	g_object_unref (job->backend);
+	g_ptr_array_unref (job->langs);
+	g_ptr_array_unref (job->skip_patterns);
+	g_clear_object (&job->cancellable);
+	if (job->results)
+		g_ptr_array_unref (job->results);
+	g_mutex_clear (&job->lock);
+	g_cond_clear (&job->done);
+	g_free (job);
+}
+
+static void
+spans_free (GArray *spans)
+{
+	/* Texts that were not reached before a cancel have no spans */
+	if (spans != NULL)
+		g_array_unref (spans);
+}
+
+static GArray *
+batch_check_text (BatchJob *job, const gchar *text, SexyDict **dicts, guint n_dicts,
+                  SexyWordList *words, GHashTable *verdicts, GString *word)
+{
+	GArray *spans = g_array_new (FALSE, FALSE, sizeof (SexySpellSpan));
+	gsize length = strlen (text);
+	SexySkipCache skip_cache;
+	guint i, j;
+
+	if (n_dicts == 0 || length > G_MAXINT)
+		return spans;
+
+	sexy_word_list_clear (words);
+	sexy_tokenize (text, (gint) length, 0, (gint) length, words);
+	sexy_skip_cache_reset (&skip_cache);
+
+	for (i = 0; i < words->len; i++)
+	{
+		SexySpellSpan span = { words->starts[i], words->ends[i] };
+		gpointer value;
+
+		if (g_unichar_isalpha (g_utf8_get_char (text + span.start)) == FALSE)
+			continue;
+
+		if (sexy_skip_rules_match (job->skip_rules, job->skip_patterns, text, (gint) length,
+		                           span.start, span.end, &skip_cache))
+			continue;
+
+		g_string_truncate (word, 0);
+		g_string_append_len (word, text + span.start, span.end - span.start);
+
+		value = g_hash_table_lookup (verdicts, word->str);
+		if (value == NULL)
+		{
+			gboolean misspelled = TRUE;
+
+			for (j = 0; j < n_dicts; j++)
+			{
+				if (sexy_dict_check (dicts[j], word->str, word->len))
+				{
+					misspelled = FALSE;
+					break;
+				}
+			}
+
+			if (g_hash_table_size (verdicts) >= BATCH_CACHE_SIZE)
+				g_hash_table_remove_all (verdicts);
+			value = GINT_TO_POINTER(misspelled + 1);
+			g_hash_table_insert (verdicts, g_strdup (word->str), value);
+		}
+
+		if (GPOINTER_TO_INT(value) - 1)
+			g_array_append_val (spans, span);
+	}
+
+	return spans;
+}
+
+static void
+batch_job_run (gpointer data, gpointer pool_data)
+{
+	BatchJob *job = data;
+	SexyDict **dicts;
+	guint n_dicts = 0, i;
+	SexyWordList *words;
+	GHashTable *verdicts;
+	GString *word;
+	gint first, n;
+
+	dicts = g_new (SexyDict*, job->langs->len);
+	for (i = 0; i < job->langs->len; i++)
+	{
+		SexyDict *dict = sexy_dict_registry_get_thread_dict (job->backend, g_ptr_array_index (job->langs, i));
+		if (dict != NULL)
+			dicts[n_dicts++] = dict;
+	}
+
+	words = sexy_word_list_new ();
+	verdicts = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	word = g_string_sized_new (64);
+
+	for (;;)
+	{
+		first = g_atomic_int_add (&job->next, BATCH_CHUNK);
+		if (first >= job->n_texts || g_cancellable_is_cancelled (job->cancellable))
+			break;
+
+		SEXY_TRACE_BEGIN (check_batch, job, MIN(BATCH_CHUNK, job->n_texts - first));
+		for (n = first; n < MIN(first + BATCH_CHUNK, job->n_texts); n++)
+			job->results->pdata[n] = batch_check_text (job, job->texts[n], dicts, n_dicts, words, verdicts, word);
+		SEXY_TRACE_END (check_batch, job, n - first);
+	}
+
+	g_string_free (word, TRUE);
+	g_hash_table_destroy (verdicts);
+	sexy_word_list_free (words);
+	g_free (dicts);
+
+	g_mutex_lock (&job->lock);
+	if (--job->n_running > 0)
+	{
+		g_mutex_unlock (&job->lock);
+		return;
+	}
+
+	if (job->task == NULL)
+	{
+		/* The caller frees the job once it is woken */
+		g_cond_signal (&job->done);
+		g_mutex_unlock (&job->lock);
+		return;
+	}
+	g_mutex_unlock (&job->lock);
+
+	if (!g_task_return_error_if_cancelled (job->task))
+	{
+		g_task_return_pointer (job->task, job->results, (GDestroyNotify) g_ptr_array_unref);
+		job->results = NULL;
+	}
+	g_object_unref (job->task);
+	batch_job_free (job);
+}
+
+static BatchJob *
+batch_job_new (SexySpellChecker *checker, const gchar * const *texts, gint n_texts, GCancellable *cancellable)
+{
+	BatchJob *job = g_new0 (BatchJob, 1);
+	GSList *li;
+	guint i;
+
+	job->texts = texts;
+	job->n_texts = n_texts;
+	job->backend = g_object_ref (checker->backend);
+	job->langs = g_ptr_array_new_with_free_func (g_free);
+	for (li = checker->dict_list; li; li = g_slist_next (li))
+		g_ptr_array_add (job->langs, sexy_dict_registry_get_lang (li->data));
+
+	job->skip_rules = checker->skip_rules;
+	job->skip_patterns = g_ptr_array_new_with_free_func ((GDestroyNotify) g_regex_unref);
+	for (i = 0; i < checker->skip_patterns->len; i++)
+		g_ptr_array_add (job->skip_patterns, g_regex_ref (g_ptr_array_index (checker->skip_patterns, i)));
+
+	job->cancellable = cancellable ? g_object_ref (cancellable) : NULL;
+	job->results = g_ptr_array_new_full (n_texts, (GDestroyNotify) spans_free);
+	g_ptr_array_set_size (job->results, n_texts);
+	g_mutex_init (&job->lock);
+	g_cond_init (&job->done);
+
+	return job;
+}
+
+/* Hands @job to as many workers as it has chunks, up to the number of
+ * batch threads of @checker. */
+static void
+batch_job_start (SexySpellChecker *checker, BatchJob *job)
+{
+	guint n_threads, n_chunks, i;
+
+	n_threads = checker->batch_threads ? checker->batch_threads : g_get_num_processors ();
+	n_chunks = (job->n_texts + BATCH_CHUNK - 1) / BATCH_CHUNK;
+	job->n_running = MAX(MIN(n_threads, n_chunks), 1);
+
+	G_LOCK (batch_pool);
+	if (batch_pool == NULL)
+		batch_pool = g_thread_pool_new (batch_job_run, NULL, job->n_running, FALSE, NULL);
+	else if (g_thread_pool_get_max_threads (batch_pool) < job->n_running)
+		g_thread_pool_set_max_threads (batch_pool, job->n_running, NULL);
+
+	for (i = 0; i < (guint) job->n_running; i++)
+		g_thread_pool_push (batch_pool, job, NULL);
+	G_UNLOCK (batch_pool);
+}
+
+/**
+ * sexy_spell_checker_check_batch:
+ * @checker: A #SexySpellChecker.
+ * @texts: (array length=n_texts): The nul-terminated texts to check.
+ * @n_texts: The number of texts.
+ * @cancellable: (nullable): A #GCancellable, or %NULL.
+ * @error: Return location for a #GError, or %NULL.
+ *
+ * Checks many texts at once, like sexy_spell_checker_check_text() does
+ * for a single one, spreading them over several threads. Each thread
+ * looks words up in its own copies of the active dictionaries, and the
+ * verdict cache of @checker is not used. See
+ * #SexySpellChecker:batch-threads for the number of threads.
+ *
+ * This blocks until all texts are checked, see
+ * sexy_spell_checker_check_batch_async() for a version that does not.
+ *
+ * Returns: (transfer full) (element-type GArray): An array holding the
+ *          misspelled #SexySpellSpan<!-- -->s of each text, in the order
+ *          of @texts, or %NULL if @cancellable was cancelled. Free with
+ *          g_ptr_array_unref().
+ *
+ * Since: 1.2
+ */
+GPtrArray *
+sexy_spell_checker_check_batch(SexySpellChecker *checker, const gchar * const *texts, guint n_texts,
+                               GCancellable *cancellable, GError **error)
+{
+	BatchJob *job;
+	GPtrArray *results = NULL;
+
+	g_return_val_if_fail (SEXY_IS_SPELL_CHECKER(checker), NULL);
+	g_return_val_if_fail (texts != NULL || n_texts == 0, NULL);
+	g_return_val_if_fail (n_texts <= G_MAXINT - BATCH_CHUNK, NULL);
+
+	job = batch_job_new (checker, texts, n_texts, cancellable);
+	batch_job_start (checker, job);
+
+	g_mutex_lock (&job->lock);
+	while (job->n_running > 0)
+		g_cond_wait (&job->done, &job->lock);
+	g_mutex_unlock (&job->lock);
+
+	if (!g_cancellable_set_error_if_cancelled (cancellable, error))
+	{
+		results = job->results;
+		job->results = NULL;
+	}
+
+	batch_job_free (job);
+	return results;
+}
+
+/**
+ * sexy_spell_checker_check_batch_async:
+ * @checker: A #SexySpellChecker.
+ * @texts: (array length=n_texts): The nul-terminated texts to check.
+ * @n_texts: The number of texts.
+ * @cancellable: (nullable): A #GCancellable, or %NULL.
+ * @callback: A #GAsyncReadyCallback to call when the texts are checked.
+ * @user_data: The data to pass to @callback.
+ *
+ * Checks many texts at once without blocking, see
+ * sexy_spell_checker_check_batch(). The texts are copied, and later
+ * changes to @checker do not affect the result.
+ *
+ * Since: 1.2
+ */
+void
+sexy_spell_checker_check_batch_async(SexySpellChecker *checker, const gchar * const *texts, guint n_texts,
+                                     GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+	BatchJob *job;
+	guint i;
+
+	g_return_if_fail (SEXY_IS_SPELL_CHECKER(checker));
+	g_return_if_fail (texts != NULL || n_texts == 0);
+	g_return_if_fail (n_texts <= G_MAXINT - BATCH_CHUNK);
+
+	job = batch_job_new (checker, NULL, n_texts, cancellable);
+	job->copy = g_new (gchar*, n_texts + 1);
+	for (i = 0; i < n_texts; i++)
+		job->copy[i] = g_strdup (texts[i]);
+	job->copy[n_texts] = NULL;
+	job->texts = (const gchar * const *) job->copy;
+
+	job->task = g_task_new (checker, cancellable, callback, user_data);
+	g_task_set_source_tag (job->task, sexy_spell_checker_check_batch_async);
+
+	batch_job_start (checker, job);
+}
+
+/**
+ * sexy_spell_checker_check_batch_finish:
+ * @checker: A #SexySpellChecker.
+ * @result: The #GAsyncResult passed to the callback.
+ * @error: Return location for a #GError, or %NULL.
+ *
+ * Finishes sexy_spell_checker_check_batch_async().
+ *
+ * Returns: (transfer full) (element-type GArray): An array holding the
+ *          misspelled #SexySpellSpan<!-- -->s of each text, or %NULL
+ *          if the check was cancelled. Free with g_ptr_array_unref().
+ *
+ * Since: 1.2
+ */
+GPtrArray *
+sexy_spell_checker_check_batch_finish(SexySpellChecker *checker, GAsyncResult *result, GError **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, checker), NULL);
+
+	return g_task_propagate_pointer (G_TASK(result), error);
+}
+
+/**
+ * sexy_spell_checker_add_to_dictionary:
+ * @checker: A #SexySpellChecker.
+ * @lang: (nullable): An active language, or %NULL for the first one.
+ * @word: The word to add.
+ *
+ * Adds @word to the personal word list of a dictionary, so it is never
+ * misspelled again. This is seen by every user of the dictionary.
+ *
+ * Since: 1.2
+ */
+void
+sexy_spell_checker_add_to_dictionary(SexySpellChecker *checker, const gchar *lang, const gchar *word)
+{
+	SexyDict *dict;
+
+	g_return_if_fail (SEXY_IS_SPELL_CHECKER(checker));
+	g_return_if_fail (word != NULL);
+
+	if (lang != NULL)
+		dict = g_hash_table_lookup (checker->dict_hash, lang);
+	else
+		dict = checker->dict_list ? checker->dict_list->data : NULL;
+
+	if (dict == NULL)
+		return;
+
+	sexy_dict_registry_add_to_personal (dict, word);
+	g_signal_emit (checker, signals[CHANGED], 0);
+}
+
+/**
+ * sexy_spell_checker_ignore_word:
+ * @checker: A #SexySpellChecker.
+ * @word: The word to ignore.
+ *
+ * Accepts @word in all active dictionaries until the process exits.
+ *
+ * Since: 1.2
+ */
+void
+sexy_spell_checker_ignore_word(SexySpellChecker *checker, const gchar *word)
+{
+	GSList *li;
+
+	g_return_if_fail (SEXY_IS_SPELL_CHECKER(checker));
+	g_return_if_fail (word != NULL);
+
+	for (li = checker->dict_list; li; li = g_slist_next (li))
+		sexy_dict_registry_add_to_session (li->data, word);
+
+	g_signal_emit (checker, signals[CHANGED], 0);
+}
+
+/**
+ * sexy_spell_checker_get_cache_size:
+ * @checker: A #SexySpellChecker.
+ *
+ * Gets the number of dictionary verdicts the checker remembers.
+ *
+ * Returns: The size of the verdict cache.
+ * Since: 1.2
+ */
+guint
+sexy_spell_checker_get_cache_size(SexySpellChecker *checker)
+{
+	g_return_val_if_fail (SEXY_IS_SPELL_CHECKER(checker), 0);
+
+	return checker->cache_size;
+}
+
+/**
+ * sexy_spell_checker_set_cache_size:
+ * @checker: A #SexySpellChecker.
+ * @size: Number of verdicts to remember, 0 to disable the cache.
+ *
+ * Sets the number of dictionary verdicts the checker remembers.
+ *
+ * Since: 1.2
+ */
+void
+sexy_spell_checker_set_cache_size(SexySpellChecker *checker, guint size)
+{
+	g_return_if_fail (SEXY_IS_SPELL_CHECKER(checker));
+
+	if (checker->cache_size == size)
+		return;
+
+	checker->cache_size = size;
+	g_hash_table_remove_all (checker->verdicts);
+	g_hash_table_remove_all (checker->old_verdicts);
+
+	g_object_notify (G_OBJECT(checker), "cache-size");
+}
+
+/**
+ * sexy_spell_checker_get_cache_stats:
+ * @checker: A #SexySpellChecker.
+ * @hits: (out) (optional): Return location for the number of lookups
+ *        answered from the cache.
+ * @misses: (out) (optional): Return location for the number of lookups
+ *          that had to go to the dictionaries.
+ *
+ * Retrieves the verdict cache statistics, which can be used to pick
+ * a #SexySpellChecker:cache-size.
+ *
+ * Since: 1.2
+ */
+void
+sexy_spell_checker_get_cache_stats(SexySpellChecker *checker, guint *hits, guint *misses)
+{
+	g_return_if_fail (SEXY_IS_SPELL_CHECKER(checker));
+
+	if (hits)
+		*hits = checker->cache_hits;
+	if (misses)
+		*misses = checker->cache_misses;
+}
+
+/**
+ * sexy_spell_checker_get_batch_threads:
+ * @checker: A #SexySpellChecker.
+ *
+ * Gets the largest number of threads a batch is checked with.
+ *
+ * Returns: The number of threads, or 0 for one per processor.
+ * Since: 1.2
+ */
+guint
+sexy_spell_checker_get_batch_threads(SexySpellChecker *checker)
+{
+	g_return_val_if_fail (SEXY_IS_SPELL_CHECKER(checker), 0);
+
+	return checker->batch_threads;
+}
+
+/**
+ * sexy_spell_checker_set_batch_threads:
+ * @checker: A #SexySpellChecker.
+ * @n_threads: Number of threads, 0 for one per processor.
+ *
+ * Sets the largest number of threads sexy_spell_checker_check_batch()
+ * spreads texts over. Each thread loads its own copy of the active
+ * dictionaries.
+ *
+ * Since: 1.2
+ */
+void
+sexy_spell_checker_set_batch_threads(SexySpellChecker *checker, guint n_threads)
+{
+	g_return_if_fail (SEXY_IS_SPELL_CHECKER(checker));
+
+	if (checker->batch_threads == n_threads)
+		return;
+
+	checker->batch_threads = n_threads;
+	g_object_notify (G_OBJECT(checker), "batch-threads");
+}
+
+/**
+ * sexy_spell_checker_get_skip_rules:
+ * @checker: A #SexySpellChecker.
+ *
+ * Gets the classes of words that are not looked up.
+ *
+ * Returns: The enabled #SexySkipRules.
+ *
+ * Since: 1.2
+ */
+SexySkipRules
+sexy_spell_checker_get_skip_rules(SexySpellChecker *checker)
+{
+	g_return_val_if_fail (SEXY_IS_SPELL_CHECKER(checker), SEXY_SKIP_NONE);
+
+	return checker->skip_rules;
+}
+
+/**
+ * sexy_spell_checker_set_skip_rules:
+ * @checker: A #SexySpellChecker.
+ * @rules: The #SexySkipRules to enable.
+ *
+ * Sets the classes of words that are never looked up in the
+ * dictionaries and never marked as misspelled. The rules look at the
+ * whole token around a word, so the parts of a URL or path are skipped
+ * together. %SEXY_SKIP_DEFAULT is enabled by default.
+ *
+ * Since: 1.2
+ */
+void
+sexy_spell_checker_set_skip_rules(SexySpellChecker *checker, SexySkipRules rules)
+{
+	g_return_if_fail (SEXY_IS_SPELL_CHECKER(checker));
+
+	if (checker->skip_rules == rules)
+		return;
+
+	checker->skip_rules = rules;
+	g_signal_emit (checker, signals[CHANGED], 0);
+}
+
+/**
+ * sexy_spell_checker_add_skip_pattern:
+ * @checker: A #SexySpellChecker.
+ * @pattern: A Perl-compatible regular expression.
+ * @error: Return location for a #GError, or %NULL.
+ *
+ * Adds a pattern for words that are never looked up, in addition to the
+ * #SexySkipRules. The pattern has to match the whole token around a
+ * word, which is the run of non-space characters without leading and
+ * trailing punctuation. Patterns are compiled once and shared between
+ * checkers.
+ *
+ * Returns: %FALSE if @pattern is invalid, and @error is set.
+ *
+ * Since: 1.2
+ */
+gboolean
+sexy_spell_checker_add_skip_pattern(SexySpellChecker *checker, const gchar *pattern, GError **error)
+{
+	GRegex *regex;
+
+	g_return_val_if_fail (SEXY_IS_SPELL_CHECKER(checker), FALSE);
+	g_return_val_if_fail (pattern != NULL, FALSE);
+
+	regex = sexy_skip_pattern_compile (pattern, error);
+	if (regex == NULL)
+		return FALSE;
+
+	g_ptr_array_add (checker->skip_patterns, regex);
+	g_signal_emit (checker, signals[CHANGED], 0);
+
+	return TRUE;
+}
+
+/**
+ * sexy_spell_checker_clear_skip_patterns:
+ * @checker: A #SexySpellChecker.
+ *
+ * Removes all patterns added with sexy_spell_checker_add_skip_pattern().
+ *
+ * Since: 1.2
+ */
+void
+sexy_spell_checker_clear_skip_patterns(SexySpellChecker *checker)
+{
+	g_return_if_fail (SEXY_IS_SPELL_CHECKER(checker));
+
+	if (checker->skip_patterns->len == 0)
+		return;
+
+	g_ptr_array_set_size (checker->skip_patterns, 0);
+	g_signal_emit (checker, signals[CHANGED], 0);
+}
+
+/* Internal API for SexySpellEntry, see sexy-spell-checker-private.h */
+
+GSList *
+sexy_spell_checker_get_dicts (SexySpellChecker *checker)
+{
+	return checker->dict_list;
+}
+
+SexyDict *
+sexy_spell_checker_get_dict (SexySpellChecker *checker, const gchar *lang)
+{
+	return g_hash_table_lookup (checker->dict_hash, lang);
+}
+
+/* Changes whenever cached verdicts become stale */
+guint
+sexy_spell_checker_get_generation (SexySpellChecker *checker)
+{
+	/* Dictionaries are shared, so another checker may have added a word */
+	return checker->dict_generation + sexy_dict_registry_get_generation ();
+}
+
+gboolean
+sexy_spell_checker_cache_lookup (SexySpellChecker *checker, const gchar *word, gboolean *misspelled)
+{
+	gpointer value;
+	guint generation;
+
+	generation = sexy_spell_checker_get_generation (checker);
+	if (checker->verdict_generation != generation)
+	{
+		g_hash_table_remove_all (checker->verdicts);
+		g_hash_table_remove_all (checker->old_verdicts);
+		checker->verdict_generation = generation;
+	}
+
+	value = g_hash_table_lookup (checker->verdicts, word);
+	if (value == NULL)
+	{
+		value = g_hash_table_lookup (checker->old_verdicts, word);
+		if (value != NULL)
+			g_hash_table_insert (checker->verdicts, g_strdup (word), value);
+	}
+
+	if (value == NULL)
+	{
+		checker->cache_misses++;
+		return FALSE;
+	}
+
+	checker->cache_hits++;
+	*misspelled = GPOINTER_TO_INT(value) - 1;
+	return TRUE;
+}
+
+void
+sexy_spell_checker_cache_insert (SexySpellChecker *checker, const gchar *word, gboolean misspelled)
+{
+	if (checker->cache_size == 0)
+		return;
+
+	/* Once the current generation is full it becomes the old one, so
+	 * words that keep being looked up survive the next round. */
+	if (g_hash_table_size (checker->verdicts) >= MAX(checker->cache_size / 2, 1))
+	{
+		GHashTable *table = checker->old_verdicts;
+
+		g_hash_table_remove_all (table);
+		checker->old_verdicts = checker->verdicts;
+		checker->verdicts = table;
+	}
+
+	g_hash_table_insert (checker->verdicts, g_strdup (word), GINT_TO_POINTER(misspelled + 1));
+}
+
+/* Looks @word up in the dictionaries, bypassing the cache */
+gboolean
+sexy_spell_checker_lookup (SexySpellChecker *checker, const gchar *word)
+{
+	GSList *li;
+
+	for (li = checker->dict_list; li; li = g_slist_next (li))
+	{
+		if (sexy_dict_check (li->data, word, -1))
+			return FALSE;
+	}
+	return TRUE;
+}
+
+gboolean
+sexy_spell_checker_skips (SexySpellChecker *checker, const gchar *text, gint text_len, gint start, gint end,
+                          SexySkipCache *cache)
+{
+	return sexy_skip_rules_match (checker->skip_rules, checker->skip_patterns, text, text_len, start, end, cache);
+}
@@ -0,0 +1,140 @@
+/*
+ * @file libsexy/sexy-spell-checker.h Spell checker without a widget
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+#pragma once
+
+#include <gio/gio.h>
+
+#include "sexy-spell-backend.h"
+
+G_BEGIN_DECLS
+
+#define SEXY_SPELL_ERROR (sexy_spell_error_quark())
+#define SEXY_TYPE_SPELL_CHECKER (sexy_spell_checker_get_type())
+G_DECLARE_FINAL_TYPE(SexySpellChecker, sexy_spell_checker, SEXY, SPELL_CHECKER, GObject)
+
+/**
+ * SexySpellError:
+ * @SEXY_SPELL_ERROR_BACKEND: Error occured in enchant when calling
+ *                            sexy_spell_entry_activate_language() or
+ *                            sexy_spell_entry_set_active_languages().
+ *
+ * Type of error.
+ */
+typedef enum {
+	SEXY_SPELL_ERROR_BACKEND
+} SexySpellError;
+
+/**
+ * SexySkipRules:
+ * @SEXY_SKIP_NONE: Look up every word.
+ * @SEXY_SKIP_NUMBERS: Words starting with a digit, like 10px or 3rd.
+ * @SEXY_SKIP_URLS: URLs, www. host names and mail addresses.
+ * @SEXY_SKIP_PATHS: Absolute, home and relative file paths.
+ * @SEXY_SKIP_HEX: Hexadecimal numbers, hashes and UUIDs.
+ * @SEXY_SKIP_CHANNELS: Chat channels like #gtk.
+ * @SEXY_SKIP_IDENTIFIERS: Code identifiers like snake_case, camelCase
+ *                         and Foo::bar.
+ * @SEXY_SKIP_DEFAULT: All of the above.
+ *
+ * Classes of words that are never looked up in the dictionaries, see
+ * sexy_spell_checker_set_skip_rules().
+ *
+ * Since: 1.2
+ */
+typedef enum {
+	SEXY_SKIP_NONE        = 0,
+	SEXY_SKIP_NUMBERS     = 1 << 0,
+	SEXY_SKIP_URLS        = 1 << 1,
+	SEXY_SKIP_PATHS       = 1 << 2,
+	SEXY_SKIP_HEX         = 1 << 3,
+	SEXY_SKIP_CHANNELS    = 1 << 4,
+	SEXY_SKIP_IDENTIFIERS = 1 << 5,
+	SEXY_SKIP_DEFAULT     = 0x3f
+} SexySkipRules;
+
+/**
+ * SexySpellSpan:
+ * @start: Byte offset of the first character of the word.
+ * @end: Byte offset just past the word.
+ *
+ * A misspelled word in a text, see sexy_spell_checker_check_text().
+ *
+ * Since: 1.2
+ */
+typedef struct {
+	gint start;
+	gint end;
+} SexySpellSpan;
+
+/**
+ * SexySpellStreamFunc:
+ * @offset: Byte offset of the word in the stream.
+ * @length: Length of the word in bytes.
+ * @word: The word, only valid during the call.
+ * @user_data: The data passed to sexy_spell_checker_check_stream().
+ *
+ * Called for every misspelled word found by
+ * sexy_spell_checker_check_stream().
+ *
+ * Since: 1.2
+ */
+typedef void (*SexySpellStreamFunc) (goffset offset, gsize length, const gchar *word, gpointer user_data);
+
+GQuark sexy_spell_error_quark(void);
+
+SexySpellChecker* sexy_spell_checker_new(void);
+SexySpellChecker* sexy_spell_checker_new_with_backend(SexySpellBackend *backend);
+SexySpellBackend* sexy_spell_checker_get_backend(SexySpellChecker *checker);
+GSList* sexy_spell_checker_get_languages(SexySpellChecker *checker);
+gboolean sexy_spell_checker_language_is_active(SexySpellChecker *checker, const gchar *lang);
+gboolean sexy_spell_checker_activate_language(SexySpellChecker *checker, const gchar *lang, GError **error);
+void sexy_spell_checker_deactivate_language(SexySpellChecker *checker, const gchar *lang);
+gboolean sexy_spell_checker_set_active_languages(SexySpellChecker *checker, GSList *langs, GError **error);
+void sexy_spell_checker_activate_language_async(SexySpellChecker *checker, const gchar *lang, GCancellable *cancellable,
+                                                GAsyncReadyCallback callback, gpointer user_data);
+gboolean sexy_spell_checker_activate_language_finish(SexySpellChecker *checker, GAsyncResult *result, GError **error);
+void sexy_spell_checker_set_active_languages_async(SexySpellChecker *checker, GSList *langs, GCancellable *cancellable,
+                                                   GAsyncReadyCallback callback, gpointer user_data);
+gboolean sexy_spell_checker_set_active_languages_finish(SexySpellChecker *checker, GAsyncResult *result, GError **error);
+GSList* sexy_spell_checker_get_active_languages(SexySpellChecker *checker);
+void sexy_spell_checker_activate_default_languages(SexySpellChecker *checker);
+gboolean sexy_spell_checker_check_word(SexySpellChecker *checker, const gchar *word, gssize length);
+GArray* sexy_spell_checker_check_text(SexySpellChecker *checker, const gchar *text, gssize length);
+gboolean sexy_spell_checker_check_stream(SexySpellChecker *checker, GInputStream *stream,
+                                         SexySpellStreamFunc func, gpointer user_data,
+                                         GCancellable *cancellable, GError **error);
+GPtrArray* sexy_spell_checker_check_batch(SexySpellChecker *checker, const gchar * const *texts, guint n_texts,
+                                          GCancellable *cancellable, GError **error);
+void sexy_spell_checker_check_batch_async(SexySpellChecker *checker, const gchar * const *texts, guint n_texts,
+                                          GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data);
+GPtrArray* sexy_spell_checker_check_batch_finish(SexySpellChecker *checker, GAsyncResult *result, GError **error);
+void sexy_spell_checker_add_to_dictionary(SexySpellChecker *checker, const gchar *lang, const gchar *word);
+void sexy_spell_checker_ignore_word(SexySpellChecker *checker, const gchar *word);
+guint sexy_spell_checker_get_cache_size(SexySpellChecker *checker);
+void sexy_spell_checker_set_cache_size(SexySpellChecker *checker, guint size);
+void sexy_spell_checker_get_cache_stats(SexySpellChecker *checker, guint *hits, guint *misses);
+guint sexy_spell_checker_get_batch_threads(SexySpellChecker *checker);
+void sexy_spell_checker_set_batch_threads(SexySpellChecker *checker, guint n_threads);
+SexySkipRules sexy_spell_checker_get_skip_rules(SexySpellChecker *checker);
+void sexy_spell_checker_set_skip_rules(SexySpellChecker *checker, SexySkipRules rules);
+gboolean sexy_spell_checker_add_skip_pattern(SexySpellChecker *checker, const gchar *pattern, GError **error);
+void sexy_spell_checker_clear_skip_patterns(SexySpellChecker *checker);
+
+G_END_DECLS
@@ -29,10 +29,17 @@
 
 #include <glib/gi18n.h>
 #include <gtk/gtk.h>
-#include <enchant.h>
 
 #include "sexy-spell-entry.h"
+#include "sexy-spell-checker-private.h"
 #include "sexy-marshal.h"
+#include "sexy-span-store.h"
+#include "sexy-dict-registry.h"
+#include "sexy-suggestions.h"
+#include "sexy-word-list.h"
+#include "sexy-char-index.h"
+#include "sexy-tokenizer.h"
+#include "sexy-trace.h"
 #include "gtkspell-iso-codes.h"
 
 /**
@@ -43,25 +50,97 @@
  * @include: libsexy3/sexy-spell-entry.h
  *
  * Text entry widget with spell check.
- * Enchant is used for the backend.
+ * Words are looked up through the #SexySpellBackend of its checker,
+ * which is Enchant unless another one is picked, see
+ * sexy_spell_checker_new_with_backend().
  *
  */
 
+typedef struct _CheckJob CheckJob;
+
 typedef struct
 {
-	EnchantBroker *broker;
 	PangoAttrList *attr_list;
 	GdkRGBA *underline_color;
 	gint mark_character;
-	GHashTable *dict_hash;
-	GSList *dict_list;
-	gchar **words;
-	gint *word_starts;
-	gint *word_ends;
+	SexySpellChecker *checker;
+	SexyWordList *words;
+	SexyWordList *fresh_words;
+	SexyCharIndex *char_index;
+	GString *scratch;
+	gboolean in_word_check;
+	SexySpanStore *misspelled;
 	gboolean checked;
 	gint preedit_length;
+
+	/* Edits seen since the last "changed", as a byte range of the
+	 * current text that has to be tokenized again. */
+	gint text_length;
+	gint damage_start;
+	gint damage_end;
+	gboolean damage_full;
+
+	/* Byte offset the text being inserted goes to, taken before
+	 * GtkEntry inserts it, or -1 if the edit is not tracked. */
+	gint insert_pos;
+
+	/* Changes are checked once per frame, and not before check_delay
+	 * milliseconds passed without another change. */
+	guint check_delay;
+	guint check_timeout_id;
+	guint check_tick_id;
+	guint check_idle_id;
+
+	/* Words outside the visible part of the text are checked in slices
+	 * from an idle, starting at the backlog_hint-th word. */
+	guint backlog_id;
+	guint backlog_hint;
+
+	/* Asynchronous checking: dictionary lookups that missed the cache are
+	 * left pending and done by check_job_run() on the check thread. */
+	gboolean async_check;
+	gboolean deferred;
+	CheckJob *check_job;
+	GHashTable *fresh_verdicts;
+
+	/* Where the cursor or pointer rests, in characters */
+	gboolean prefetch_suggestions;
+	guint prefetch_timeout_id;
+	gint prefetch_position;
+
+	/* The token of the word checked last, see sexy_skip_rules_match() */
+	SexySkipCache skip_cache;
+
+	SexySpellStats stats;
 } SexySpellEntryPrivate;
 
+/* Every entry lives in the main thread, so the statistics are plain
+ * counters, added to the entry's and to the process-wide ones at once. */
+static SexySpellStats global_stats;
+
+#define STATS_ADD(priv, field, n) \
+	G_STMT_START { (priv)->stats.field += (n); global_stats.field += (n); } G_STMT_END
+
+typedef struct
+{
+	SexySpellEntry *entry;
+	GtkWidget *menu;
+	GtkWidget *placeholder;
+	SexyDict *dict;
+} SuggestionsMenu;
+
+struct _CheckJob
+{
+	SexySpellEntry *entry;
+	GCancellable *cancellable;
+	SexySpellBackend *backend;
+	GPtrArray *langs;
+	GPtrArray *words;
+	gboolean *misspelled;
+	guint n_checked;
+	guint generation;
+};
+
 static void sexy_spell_entry_class_init(SexySpellEntryClass *klass);
 static void sexy_spell_entry_editable_init (GtkEditableInterface *iface);
 static void sexy_spell_entry_init (SexySpellEntry *entry);
@@ -69,6 +148,7 @@ static void sexy_spell_entry_finalize (GObject *obj);
 static void sexy_spell_entry_dispose (GObject *obj);
 static gint sexy_spell_entry_draw (GtkWidget *widget, cairo_t *cr);
 static gint sexy_spell_entry_button_press(GtkWidget *widget, GdkEventButton *event);
+static gboolean sexy_spell_entry_motion_notify (GtkWidget *widget, GdkEventMotion *event);
 static void sexy_spell_entry_set_property (GObject *obj, guint prop_id, const GValue *value, GParamSpec *pspec);
 static void sexy_spell_entry_get_property (GObject *obj, guint prop_id, GValue *value, GParamSpec *pspec);
 static void sexy_spell_entry_style_updated (GtkWidget *widget);
@@ -76,19 +156,27 @@ static void sexy_spell_entry_style_updated (GtkWidget *widget);
 
 /* GtkEditable handlers */
 static void sexy_spell_entry_changed (GtkEditable *editable, gpointer data);
+static void sexy_spell_entry_before_insert_text (GtkEditable *editable, gchar *new_text, gint new_text_length,
+                                                 gint *position, gpointer data);
+static void sexy_spell_entry_insert_text (GtkEditable *editable, gchar *new_text, gint new_text_length,
+                                          gint *position, gpointer data);
+static void sexy_spell_entry_delete_text (GtkEditable *editable, gint start_pos, gint end_pos, gpointer data);
 
 /* Other handlers */
 static gboolean sexy_spell_entry_popup_menu (GtkWidget *widget, SexySpellEntry *entry);
+static void sexy_spell_entry_cursor_moved (GObject *object, GParamSpec *pspec, gpointer data);
+static void sexy_spell_entry_scrolled (GObject *object, GParamSpec *pspec, gpointer data);
+static void sexy_spell_entry_checker_changed (SexySpellChecker *checker, gpointer data);
 
 /* Internal utility functions */
 static gint sexy_spell_entry_find_position (SexySpellEntry *entry, gint x);
 static gboolean word_misspelled (SexySpellEntry *entry, int start, int end);
 static gboolean default_word_check (SexySpellEntry *entry, const gchar *word);
-static gboolean sexy_spell_entry_activate_language_internal (SexySpellEntry *entry,
-                                                            const gchar *lang, GError **error);
-static gchar* get_lang_from_dict (EnchantDict *dict);
 static void sexy_spell_entry_recheck_all (SexySpellEntry *entry);
-static void entry_strsplit_utf8 (GtkEntry *entry, gchar ***set, gint **starts, gint **ends);
+static void sexy_spell_entry_update_attributes (SexySpellEntry *entry);
+static void sexy_spell_entry_check_word (SexySpellEntry *entry, SexyWordList *words, guint index);
+static void sexy_spell_entry_queue_check (SexySpellEntry *entry);
+static void entry_strsplit_utf8 (SexySpellEntry *entry, gint start, gint end, SexyWordList *words);
 
 G_DEFINE_TYPE_WITH_CODE (SexySpellEntry, sexy_spell_entry, GTK_TYPE_ENTRY,
 	G_IMPLEMENT_INTERFACE(GTK_TYPE_EDITABLE, sexy_spell_entry_editable_init)
@@ -97,7 +185,10 @@ G_DEFINE_TYPE_WITH_CODE (SexySpellEntry, sexy_spell_entry, GTK_TYPE_ENTRY,
 #define SEXY_SPELL_ENTRY_GET_PRIVATE(obj) \
 		(G_TYPE_INSTANCE_GET_PRIVATE ((obj), SEXY_TYPE_SPELL_ENTRY, SexySpellEntryPriv))
 
-static int codetable_ref = 0;
+static GThreadPool *check_pool = NULL;
+
+#define PREFETCH_DELAY 300
+#define CHECK_SLICE_USEC 4000
 
 enum
 {
@@ -110,6 +201,10 @@ enum
 {
 	PROP_0,
 	PROP_CHECKED,
+	PROP_CACHE_SIZE,
+	PROP_ASYNC_CHECK,
+	PROP_CHECK_DELAY,
+	PROP_PREFETCH_SUGGESTIONS,
 	N_PROPERTIES
 };
 
@@ -127,12 +222,11 @@ spell_accumulator(GSignalInvocationHint *hint, GValue *return_accu, const GValue
 static void
 free_words (SexySpellEntryPrivate *priv)
 {
-	if (priv->words)
-		g_strfreev (priv->words);
-	if (priv->word_starts)
-		g_free (priv->word_starts);
-	if (priv->word_ends)
-		g_free (priv->word_ends);
+	sexy_word_list_clear (priv->words);
+	sexy_char_index_invalidate (priv->char_index, 0);
+	priv->damage_start = -1;
+	priv->damage_end = -1;
+	priv->damage_full = TRUE;
 }
 
 static void
@@ -152,6 +246,7 @@ sexy_spell_entry_class_init(SexySpellEntryClass *klass)
 	object_class->dispose = sexy_spell_entry_dispose;
 
 	widget_class->draw = sexy_spell_entry_draw;
+	widget_class->motion_notify_event = sexy_spell_entry_motion_notify;
 	widget_class->button_press_event = sexy_spell_entry_button_press;
 	widget_class->style_updated = sexy_spell_entry_style_updated;
 
@@ -175,7 +270,7 @@ sexy_spell_entry_class_init(SexySpellEntryClass *klass)
 					   (GSignalAccumulator) spell_accumulator, NULL,
 					   sexy_marshal_BOOLEAN__STRING,
 					   G_TYPE_BOOLEAN,
-					   1, G_TYPE_STRING);
+					   1, G_TYPE_STRING | G_SIGNAL_TYPE_STATIC_SCOPE);
 
 	/**
 	 * SexySpellEntry:checked:
@@ -188,6 +283,62 @@ sexy_spell_entry_class_init(SexySpellEntryClass *klass)
 							g_param_spec_boolean ("checked", "Checked",
 										"If checking spelling is enabled",
 										TRUE, G_PARAM_READWRITE));
+	/**
+	 * SexySpellEntry:cache-size:
+	 *
+	 * The number of dictionary verdicts remembered by the entry, so that
+	 * words which were already checked don't go through the dictionaries
+	 * again. 0 disables the cache.
+	 *
+	 * Since: 1.2
+	 */
+	g_object_class_install_property (object_class, PROP_CACHE_SIZE,
+							g_param_spec_uint ("cache-size", "Cache Size",
+										"Number of dictionary verdicts to remember",
+										0, G_MAXUINT, SEXY_SPELL_CHECKER_DEFAULT_CACHE_SIZE, G_PARAM_READWRITE));
+	/**
+	 * SexySpellEntry:async-check:
+	 *
+	 * If words are looked up in the dictionaries on a worker thread.
+	 * Typing then never waits for the dictionaries, and new misspellings
+	 * are underlined shortly after they were typed.
+	 *
+	 * The #SexySpellEntry::word-check signal is still emitted in the
+	 * main thread.
+	 *
+	 * Since: 1.2
+	 */
+	g_object_class_install_property (object_class, PROP_ASYNC_CHECK,
+							g_param_spec_boolean ("async-check", "Asynchronous Check",
+										"If words are looked up on a worker thread",
+										FALSE, G_PARAM_READWRITE));
+	/**
+	 * SexySpellEntry:check-delay:
+	 *
+	 * The number of milliseconds to wait after a change before the new
+	 * text is checked. Every further change starts the wait again, so
+	 * nothing is checked while the user is typing quickly. With 0, the
+	 * text is checked in the next frame.
+	 *
+	 * Since: 1.2
+	 */
+	g_object_class_install_property (object_class, PROP_CHECK_DELAY,
+							g_param_spec_uint ("check-delay", "Check Delay",
+										"Milliseconds to wait after a change before checking",
+										0, G_MAXUINT, 0, G_PARAM_READWRITE));
+	/**
+	 * SexySpellEntry:prefetch-suggestions:
+	 *
+	 * If spelling suggestions are computed in the background as soon as
+	 * the cursor or the pointer rests on a misspelled word, so that the
+	 * context menu can show them right away.
+	 *
+	 * Since: 1.2
+	 */
+	g_object_class_install_property (object_class, PROP_PREFETCH_SUGGESTIONS,
+							g_param_spec_boolean ("prefetch-suggestions", "Prefetch Suggestions",
+										"If suggestions for the misspelled word under the cursor are computed in advance",
+										FALSE, G_PARAM_READWRITE));
 	/**
 	 * SexySpellEntry:underline-color:
 	 *
@@ -217,6 +368,18 @@ sexy_spell_entry_set_property (GObject *obj, guint prop_id, const GValue *value,
 		case PROP_CHECKED:
 			sexy_spell_entry_set_checked (entry, g_value_get_boolean(value));
 			break;
+		case PROP_CACHE_SIZE:
+			sexy_spell_entry_set_cache_size (entry, g_value_get_uint(value));
+			break;
+		case PROP_ASYNC_CHECK:
+			sexy_spell_entry_set_async_check (entry, g_value_get_boolean(value));
+			break;
+		case PROP_CHECK_DELAY:
+			sexy_spell_entry_set_check_delay (entry, g_value_get_uint(value));
+			break;
+		case PROP_PREFETCH_SUGGESTIONS:
+			sexy_spell_entry_set_prefetch_suggestions (entry, g_value_get_boolean(value));
+			break;
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (obj, prop_id, pspec);
 			break;
@@ -233,12 +396,206 @@ sexy_spell_entry_get_property (GObject *obj, guint prop_id, GValue *value, GPara
 		case PROP_CHECKED:
 			g_value_set_boolean (value, sexy_spell_entry_get_checked (entry));
 			break;
+		case PROP_CACHE_SIZE:
+			g_value_set_uint (value, sexy_spell_entry_get_cache_size (entry));
+			break;
+		case PROP_ASYNC_CHECK:
+			g_value_set_boolean (value, sexy_spell_entry_get_async_check (entry));
+			break;
+		case PROP_CHECK_DELAY:
+			g_value_set_uint (value, sexy_spell_entry_get_check_delay (entry));
+			break;
+		case PROP_PREFETCH_SUGGESTIONS:
+			g_value_set_boolean (value, sexy_spell_entry_get_prefetch_suggestions (entry));
+			break;
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (obj, prop_id, pspec);
 			break;
 	}
 }
 
+static void
+check_job_free (CheckJob *job)
+{
+	g_object_unref (job->entry);
+	g_object_unref (job->cancellable);
+	g_object_unref (job->backend);
+	g_ptr_array_unref (job->langs);
+	g_ptr_array_unref (job->words);
+	g_free (job->misspelled);
+	g_free (job);
+}
+
+static gboolean
+check_job_done (gpointer data)
+{
+	CheckJob *job = data;
+	SexySpellEntry *entry = job->entry;
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+	gboolean cancelled = g_cancellable_is_cancelled (job->cancellable);
+	guint i;
+
+	if (priv->check_job == job)
+		priv->check_job = NULL;
+
+	STATS_ADD (priv, lookups, job->n_checked);
+
+	/* Verdicts of a cancelled job are still good, as long as the
+	 * dictionaries did not change in the meantime */
+	if (job->generation != sexy_spell_checker_get_generation (priv->checker))
+	{
+		if (!cancelled)
+			sexy_spell_entry_queue_check (entry);
+		check_job_free (job);
+		return G_SOURCE_REMOVE;
+	}
+
+	priv->fresh_verdicts = g_hash_table_new (g_str_hash, g_str_equal);
+	for (i = 0; i < job->n_checked; i++)
+	{
+		const gchar *word = g_ptr_array_index (job->words, i);
+
+		sexy_spell_checker_cache_insert (priv->checker, word, job->misspelled[i]);
+		g_hash_table_insert (priv->fresh_verdicts, (gpointer) word,
+		                     GINT_TO_POINTER(job->misspelled[i]));
+	}
+
+	/* A cancelled job has already been replaced by a newer one */
+	if (!cancelled)
+	{
+		for (i = 0; i < priv->words->len; i++)
+		{
+			if (priv->words->verdicts[i] == SEXY_WORD_PENDING)
+				sexy_spell_entry_check_word (entry, priv->words, i);
+		}
+
+		sexy_spell_entry_queue_check (entry);
+
+		if (sexy_span_store_get_changed (priv->misspelled))
+			sexy_spell_entry_update_attributes (entry);
+	}
+
+	g_hash_table_destroy (priv->fresh_verdicts);
+	priv->fresh_verdicts = NULL;
+
+	check_job_free (job);
+	return G_SOURCE_REMOVE;
+}
+
+static void
+check_job_run (gpointer data, gpointer pool_data)
+{
+	CheckJob *job = data;
+	guint i, j;
+
+	SEXY_TRACE_BEGIN (check_batch, job->entry, job->words->len);
+	for (i = 0; i < job->words->len; i++)
+	{
+		const gchar *word = g_ptr_array_index (job->words, i);
+
+		if (g_cancellable_is_cancelled (job->cancellable))
+			break;
+
+		job->misspelled[i] = TRUE;
+		for (j = 0; j < job->langs->len; j++)
+		{
+			SexyDict *dict = sexy_dict_registry_get_thread_dict (job->backend, g_ptr_array_index (job->langs, j));
+
+			if (dict && sexy_dict_check (dict, word, -1))
+			{
+				job->misspelled[i] = FALSE;
+				break;
+			}
+		}
+	}
+	job->n_checked = i;
+	SEXY_TRACE_END (check_batch, job->entry, i);
+
+	g_idle_add (check_job_done, job);
+}
+
+static void
+sexy_spell_entry_cancel_check(SexySpellEntry *entry)
+{
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+
+	if (priv->check_job)
+	{
+		g_cancellable_cancel (priv->check_job->cancellable);
+		priv->check_job = NULL;
+	}
+}
+
+/* Starts looking up the pending words on the check thread, replacing
+ * the lookup that may still be running for an older text. */
+static void
+sexy_spell_entry_queue_check(SexySpellEntry *entry)
+{
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+	const gchar *text;
+	GHashTable *seen;
+	CheckJob *job;
+	GSList *li;
+	guint i;
+
+	sexy_spell_entry_cancel_check (entry);
+
+	job = g_new0 (CheckJob, 1);
+	job->words = g_ptr_array_new_with_free_func (g_free);
+
+	text = gtk_entry_get_text (GTK_ENTRY(entry));
+	seen = g_hash_table_new (g_str_hash, g_str_equal);
+	for (i = 0; i < priv->words->len; i++)
+	{
+		gchar *word;
+
+		if (priv->words->verdicts[i] != SEXY_WORD_PENDING)
+			continue;
+
+		word = g_strndup (text + priv->words->starts[i], priv->words->ends[i] - priv->words->starts[i]);
+		if (g_hash_table_contains (seen, word))
+		{
+			g_free (word);
+			continue;
+		}
+		g_hash_table_add (seen, word);
+		g_ptr_array_add (job->words, word);
+	}
+	g_hash_table_destroy (seen);
+
+	if (job->words->len == 0)
+	{
+		g_ptr_array_unref (job->words);
+		g_free (job);
+		return;
+	}
+
+	job->entry = g_object_ref (entry);
+	job->cancellable = g_cancellable_new ();
+	job->misspelled = g_new0 (gboolean, job->words->len);
+	job->generation = sexy_spell_checker_get_generation (priv->checker);
+	job->backend = g_object_ref (sexy_spell_checker_get_backend (priv->checker));
+	job->langs = g_ptr_array_new_with_free_func (g_free);
+	for (li = sexy_spell_checker_get_dicts (priv->checker); li; li = g_slist_next (li))
+		g_ptr_array_add (job->langs, sexy_dict_registry_get_lang (li->data));
+
+	/* A single thread, so there is only one extra copy of each dictionary */
+	if (check_pool == NULL)
+		check_pool = g_thread_pool_new (check_job_run, NULL, 1, FALSE, NULL);
+
+	priv->check_job = job;
+	g_thread_pool_push (check_pool, job, NULL);
+}
+
+static gint
+get_scroll_offset (SexySpellEntry *entry)
+{
+	gint scroll_offset = 0;
+
+	g_object_get (G_OBJECT(entry), "scroll-offset", &scroll_offset, NULL);
+	return scroll_offset;
+}
+
 static gint
 sexy_spell_entry_find_position (SexySpellEntry *entry, gint x)
 {
@@ -251,7 +608,7 @@ sexy_spell_entry_find_position (SexySpellEntry *entry, gint x)
 	gint pos;
 	gboolean trailing;
 
-	x = x + GPOINTER_TO_INT(g_object_get_data (G_OBJECT(entry), "scroll-offset"));
+	x = x + get_scroll_offset (entry);
 
 	layout = gtk_entry_get_layout (GTK_ENTRY(entry));
 	text = pango_layout_get_text (layout);
@@ -305,6 +662,7 @@ insert_underline(SexySpellEntry *entry, guint start, guint end)
 	pango_attr_list_insert (priv->attr_list, unline);
 }
 
+/* Finds the word at the character @position, as byte offsets */
 static void
 get_word_extents_from_position(SexySpellEntry *entry, gint *start, gint *end, guint position)
 {
@@ -315,44 +673,51 @@ get_word_extents_from_position(SexySpellEntry *entry, gint *start, gint *end, gu
 	*start = -1;
 	*end = -1;
 
-	if (priv->words == NULL)
+	if (priv->words->len == 0)
 		return;
 
 	text = gtk_entry_get_text (GTK_ENTRY(entry));
-	bytes_pos = (gint)(g_utf8_offset_to_pointer(text, position) - text);
+	bytes_pos = sexy_char_index_char_to_byte (priv->char_index, text, position);
 
-	for (i = 0; priv->words[i]; i++)
+	i = sexy_word_list_find (priv->words, bytes_pos);
+	if (i >= 0)
 	{
-		if (bytes_pos >= priv->word_starts[i] &&
-		    bytes_pos <= priv->word_ends[i])
-		{
-			*start = priv->word_starts[i];
-			*end   = priv->word_ends[i];
-			return;
-		}
+		*start = priv->words->starts[i];
+		*end   = priv->words->ends[i];
 	}
 }
 
+static gchar *
+get_word_at_mark(SexySpellEntry *entry)
+{
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+	const gchar *text;
+	gint start, end;
+
+	get_word_extents_from_position (entry, &start, &end, priv->mark_character);
+	if (start < 0)
+		return NULL;
+
+	text = gtk_entry_get_text (GTK_ENTRY(entry));
+	return g_strndup (text + start, end - start);
+}
+
 static void
 add_to_dictionary(GtkWidget *menuitem, SexySpellEntry *entry)
 {
 	char *word;
-	gint start, end;
-	EnchantDict *dict;
-	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+	SexyDict *dict;
 
-	get_word_extents_from_position (entry, &start, &end, priv->mark_character);
-	word = gtk_editable_get_chars (GTK_EDITABLE(entry), start, end);
+	word = get_word_at_mark (entry);
+	if (word == NULL)
+		return;
 
-	dict = (EnchantDict *) g_object_get_data(G_OBJECT(menuitem), "enchant-dict");
+	dict = g_object_get_data(G_OBJECT(menuitem), "sexy-dict");
 	if (dict)
-		enchant_dict_add_to_personal(dict, word, -1);
+		sexy_dict_registry_add_to_personal (dict, word);
 
 	g_free(word);
 
-	free_words (priv);
-	entry_strsplit_utf8 (GTK_ENTRY(entry), &priv->words,
-						&priv->word_starts, &priv->word_ends);
 	sexy_spell_entry_recheck_all (entry);
 }
 
@@ -360,41 +725,40 @@ static void
 ignore_all(GtkWidget *menuitem, SexySpellEntry *entry)
 {
 	char *word;
-	gint start, end;
-	GSList *li;
 	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
 
-	get_word_extents_from_position (entry, &start, &end, priv->mark_character);
-	word = gtk_editable_get_chars (GTK_EDITABLE(entry), start, end);
+	word = get_word_at_mark (entry);
+	if (word == NULL)
+		return;
 
-	for (li = priv->dict_list; li; li = g_slist_next (li))
-	{
-		EnchantDict *dict = (EnchantDict *) li->data;
-		enchant_dict_add_to_session (dict, word, -1);
-	}
+	/* The checker tells the entry to check again */
+	sexy_spell_checker_ignore_word (priv->checker, word);
 
 	g_free (word);
-
-	free_words (priv);
-	entry_strsplit_utf8(GTK_ENTRY(entry), &priv->words,
-						&priv->word_starts, &priv->word_ends);
-	sexy_spell_entry_recheck_all(entry);
 }
 
 static void
 replace_word(GtkWidget *menuitem, SexySpellEntry *entry)
 {
 	char *oldword;
-	const char *newword;
+	const char *text, *newword;
 	gint start, end;
 	gint cursor;
-	EnchantDict *dict;
+	SexyDict *dict;
   	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
 
 	get_word_extents_from_position (entry, &start, &end, priv->mark_character);
-	oldword = gtk_editable_get_chars (GTK_EDITABLE(entry), start, end);
+	if (start < 0)
+		return;
+
+	text = gtk_entry_get_text (GTK_ENTRY(entry));
+	oldword = g_strndup (text + start, end - start);
 	newword = gtk_label_get_text (GTK_LABEL(gtk_bin_get_child (GTK_BIN(menuitem))));
 
+	/* The editable wants characters */
+	start = sexy_char_index_byte_to_char (priv->char_index, text, start);
+	end = sexy_char_index_byte_to_char (priv->char_index, text, end);
+
 	cursor = gtk_editable_get_position (GTK_EDITABLE(entry));
 	/* is the cursor at the end? If so, restore it there */
 	if (g_utf8_strlen(gtk_entry_get_text (GTK_ENTRY(entry)), -1) == cursor)
@@ -407,26 +771,31 @@ replace_word(GtkWidget *menuitem, SexySpellEntry *entry)
 	gtk_editable_insert_text (GTK_EDITABLE(entry), newword, strlen(newword), &start);
 	gtk_editable_set_position (GTK_EDITABLE(entry), cursor);
 
-	dict = (EnchantDict*)g_object_get_data(G_OBJECT(menuitem), "enchant-dict");
+	dict = g_object_get_data(G_OBJECT(menuitem), "sexy-dict");
 
 	if (dict)
-		enchant_dict_store_replacement(dict,
-					       oldword, -1,
-					       newword, -1);
+		sexy_dict_store_replacement (dict, oldword, newword);
 
 	g_free(oldword);
 }
 
+/* Menus keep their dictionary alive, the entry may drop it while they
+ * are shown */
 static void
-build_suggestion_menu(SexySpellEntry *entry, GtkWidget *menu, EnchantDict *dict, const gchar *word)
+set_menu_dict(gpointer object, SexyDict *dict)
 {
-	GtkWidget *mi;
-	gchar **suggestions;
-	size_t n_suggestions, i;
+	g_object_set_data_full (G_OBJECT(object), "sexy-dict", sexy_dict_registry_ref (dict),
+	                        (GDestroyNotify) sexy_dict_registry_release);
+}
 
-	suggestions = enchant_dict_suggest (dict, word, -1, &n_suggestions);
+static void
+fill_suggestion_menu(SexySpellEntry *entry, GtkWidget *menu, SexyDict *dict,
+                     const gchar * const *suggestions)
+{
+	GtkWidget *mi;
+	guint i;
 
-	if (suggestions == NULL || n_suggestions == 0)
+	if (suggestions[0] == NULL)
 	{
 		/* no suggestions.  put something in the menu anyway... */
 		GtkWidget *label = gtk_label_new ("");
@@ -440,7 +809,7 @@ build_suggestion_menu(SexySpellEntry *entry, GtkWidget *menu, EnchantDict *dict,
 	else
 	{
 		/* build a set of menus with suggestions */
-		for (i = 0; i < n_suggestions; i++)
+		for (i = 0; suggestions[i] != NULL; i++)
 		{
 			if ((i != 0) && (i % 10 == 0))
 			{
@@ -457,33 +826,136 @@ build_suggestion_menu(SexySpellEntry *entry, GtkWidget *menu, EnchantDict *dict,
 			}
 
 			mi = gtk_menu_item_new_with_label (suggestions[i]);
-			g_object_set_data (G_OBJECT(mi), "enchant-dict", dict);
+			set_menu_dict (mi, dict);
 			g_signal_connect (G_OBJECT(mi), "activate", G_CALLBACK(replace_word), entry);
 			gtk_widget_show (mi);
 			gtk_menu_shell_append (GTK_MENU_SHELL(menu), mi);
 		}
 	}
+}
+
+static void
+sexy_spell_entry_count_suggestions(SexySpellEntry *entry, gint64 elapsed)
+{
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+
+	/* Someone else asked for the same word first */
+	if (elapsed < 0)
+		return;
+
+	STATS_ADD (priv, suggestion_calls, 1);
+	STATS_ADD (priv, suggestion_time, elapsed);
+}
+
+static void
+suggestions_prefetched(const gchar * const *suggestions, gint64 elapsed, gpointer user_data)
+{
+	SexySpellEntry *entry = user_data;
+
+	sexy_spell_entry_count_suggestions (entry, elapsed);
+	g_object_unref (entry);
+}
+
+static void
+sexy_spell_entry_fetch_suggestions(SexySpellEntry *entry, SexyDict *dict, const gchar *word)
+{
+	sexy_suggestions_fetch (dict, word, suggestions_prefetched, g_object_ref (entry));
+}
+
+static void
+suggestions_menu_ready(const gchar * const *suggestions, gint64 elapsed, gpointer user_data)
+{
+	SuggestionsMenu *data = user_data;
+
+	sexy_spell_entry_count_suggestions (data->entry, elapsed);
+
+	/* Unless the menu was closed in the meantime */
+	if (gtk_widget_get_parent (data->placeholder) == data->menu)
+	{
+		gtk_widget_destroy (data->placeholder);
+		fill_suggestion_menu (data->entry, data->menu, data->dict, suggestions);
+	}
+
+	sexy_dict_registry_release (data->dict);
+	g_object_unref (data->placeholder);
+	g_object_unref (data->menu);
+	g_object_unref (data->entry);
+	g_free (data);
+}
+
+static void
+build_suggestion_menu(SexySpellEntry *entry, GtkWidget *menu, SexyDict *dict, const gchar *word)
+{
+	const gchar * const *suggestions;
+	SuggestionsMenu *data;
+	GtkWidget *label;
+
+	suggestions = sexy_suggestions_lookup (dict, word);
+	if (suggestions != NULL)
+	{
+		fill_suggestion_menu (entry, menu, dict, suggestions);
+		return;
+	}
+
+	/* Show the menu now and fill it in when the suggestions arrive */
+	data = g_new0 (SuggestionsMenu, 1);
+	data->entry = g_object_ref (entry);
+	data->menu = g_object_ref (menu);
+	data->dict = sexy_dict_registry_ref (dict);
+
+	label = gtk_label_new ("");
+	gtk_label_set_markup (GTK_LABEL(label), _("<i>(looking up suggestions...)</i>"));
+	data->placeholder = gtk_separator_menu_item_new ();
+	gtk_container_add (GTK_CONTAINER(data->placeholder), label);
+	gtk_widget_show_all (data->placeholder);
+	gtk_menu_shell_prepend (GTK_MENU_SHELL(menu), data->placeholder);
+	g_object_ref (data->placeholder);
+
+	sexy_suggestions_fetch (dict, word, suggestions_menu_ready, data);
+}
+
+static void
+suggestion_submenu_show(GtkWidget *menu, SexySpellEntry *entry)
+{
+	SexyDict *dict = g_object_get_data (G_OBJECT(menu), "sexy-dict");
+	const gchar *word = g_object_get_data (G_OBJECT(menu), "sexy-word");
+
+	g_signal_handlers_disconnect_by_func (menu, suggestion_submenu_show, entry);
+	build_suggestion_menu (entry, menu, dict, word);
+}
+
+static void
+suggestion_submenu_select(GtkWidget *mi, SexySpellEntry *entry)
+{
+	GtkWidget *menu = gtk_menu_item_get_submenu (GTK_MENU_ITEM(mi));
+	SexyDict *dict = g_object_get_data (G_OBJECT(menu), "sexy-dict");
+	const gchar *word = g_object_get_data (G_OBJECT(menu), "sexy-word");
+
+	/* Get going while the submenu waits to pop up */
+	if (sexy_suggestions_lookup (dict, word) == NULL)
+		sexy_spell_entry_fetch_suggestions (entry, dict, word);
 
-	enchant_dict_free_suggestions(dict, suggestions);
+	g_signal_handlers_disconnect_by_func (mi, suggestion_submenu_select, entry);
 }
 
 static GtkWidget *
 build_spelling_menu(SexySpellEntry *entry, const gchar *word)
 {
-	EnchantDict *dict;
+	SexyDict *dict;
 	GtkWidget *topmenu, *mi;
 	gchar *label;
 	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+	GSList *dicts = sexy_spell_checker_get_dicts (priv->checker);
 
 	topmenu = gtk_menu_new ();
 
-	if (priv->dict_list == NULL)
+	if (dicts == NULL)
 		return topmenu;
 
 	/* Suggestions */
-	if (g_slist_length(priv->dict_list) == 1)
+	if (g_slist_length(dicts) == 1)
 	{
-		dict = (EnchantDict*)priv->dict_list->data;
+		dict = dicts->data;
 		build_suggestion_menu (entry, topmenu, dict, word);
 	}
 	else
@@ -492,10 +964,10 @@ build_spelling_menu(SexySpellEntry *entry, const gchar *word)
 		GtkWidget *menu;
 		gchar *lang, *lang_name;
 
-		for (li = priv->dict_list; li; li = g_slist_next (li))
+		for (li = dicts; li; li = g_slist_next (li))
 		{
-			dict = (EnchantDict*)li->data;
-			lang = get_lang_from_dict (dict);
+			dict = li->data;
+			lang = sexy_dict_registry_get_lang (dict);
 			lang_name = sexy_spell_entry_get_language_name (entry, lang);
 			if (lang_name)
 			{
@@ -512,7 +984,13 @@ build_spelling_menu(SexySpellEntry *entry, const gchar *word)
 			gtk_menu_shell_append (GTK_MENU_SHELL(topmenu), mi);
 			menu = gtk_menu_new ();
 			gtk_menu_item_set_submenu (GTK_MENU_ITEM(mi), menu);
-			build_suggestion_menu (entry, menu, dict, word);
+
+			/* Usually only one language is looked at, so the
+			 * suggestions are filled in when its submenu is shown */
+			set_menu_dict (menu, dict);
+			g_object_set_data_full (G_OBJECT(menu), "sexy-word", g_strdup (word), g_free);
+			g_signal_connect (G_OBJECT(menu), "show", G_CALLBACK(suggestion_submenu_show), entry);
+			g_signal_connect (G_OBJECT(mi), "select", G_CALLBACK(suggestion_submenu_select), entry);
 		}
 	}
 
@@ -526,10 +1004,10 @@ build_spelling_menu(SexySpellEntry *entry, const gchar *word)
 	mi = gtk_menu_item_new_with_label (label);
 	g_free (label);
 
-	if (g_slist_length (priv->dict_list) == 1)
+	if (g_slist_length (dicts) == 1)
 	{
-		dict = (EnchantDict*)priv->dict_list->data;
-		g_object_set_data (G_OBJECT(mi), "enchant-dict", dict);
+		dict = dicts->data;
+		set_menu_dict (mi, dict);
 		g_signal_connect (G_OBJECT(mi), "activate", G_CALLBACK(add_to_dictionary), entry);
 	}
 	else
@@ -541,10 +1019,10 @@ build_spelling_menu(SexySpellEntry *entry, const gchar *word)
 		menu = gtk_menu_new ();
 		gtk_menu_item_set_submenu (GTK_MENU_ITEM(mi), menu);
 
-		for (li = priv->dict_list; li; li = g_slist_next (li))
+		for (li = dicts; li; li = g_slist_next (li))
 		{
-			dict = (EnchantDict*)li->data;
-			lang = get_lang_from_dict (dict);
+			dict = li->data;
+			lang = sexy_dict_registry_get_lang (dict);
 			lang_name = sexy_spell_entry_get_language_name (entry, lang);
 			if (lang_name)
 			{
@@ -557,7 +1035,7 @@ build_spelling_menu(SexySpellEntry *entry, const gchar *word)
 			}
 			g_free (lang);
 
-			g_object_set_data (G_OBJECT(submi), "enchant-dict", dict);
+			set_menu_dict (submi, dict);
 			g_signal_connect (G_OBJECT(submi), "activate", G_CALLBACK(add_to_dictionary), entry);
 
 			gtk_widget_show (submi);
@@ -595,7 +1073,7 @@ sexy_spell_entry_populate_popup(SexySpellEntry *entry, GtkMenu *menu, gpointer d
 	if (priv->checked == FALSE)
 		return;
 
-	if (g_slist_length (priv->dict_list) == 0)
+	if (g_slist_length (sexy_spell_checker_get_dicts (priv->checker)) == 0)
 		return;
 
 	get_word_extents_from_position (entry, &start, &end, priv->mark_character);
@@ -612,8 +1090,7 @@ sexy_spell_entry_populate_popup(SexySpellEntry *entry, GtkMenu *menu, gpointer d
 	/* Above the separator, show the suggestions menu */
 	mi = gtk_menu_item_new_with_label (_("Spelling Suggestions"));
 
-	word = gtk_editable_get_chars (GTK_EDITABLE(entry), start, end);
-	g_assert (word != NULL);
+	word = g_strndup (gtk_entry_get_text (GTK_ENTRY(entry)) + start, end - start);
 	gtk_menu_item_set_submenu (GTK_MENU_ITEM(mi), build_spelling_menu(entry, word));
 	g_free (word);
 
@@ -625,16 +1102,23 @@ static void
 sexy_spell_entry_init(SexySpellEntry *entry)
 {
 	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
-	priv->dict_hash = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
-
-	sexy_spell_entry_activate_default_languages (entry);
-
-	if (codetable_ref == 0)
-		codetable_init ();
-	codetable_ref++;
-
+	priv->words = sexy_word_list_new ();
+	priv->fresh_words = sexy_word_list_new ();
+	priv->char_index = sexy_char_index_new ();
+	priv->scratch = g_string_sized_new (64);
+	priv->misspelled = sexy_span_store_new ();
+	priv->damage_start = -1;
+	priv->damage_end = -1;
+	priv->damage_full = TRUE;
+	priv->insert_pos = -1;
+	sexy_skip_cache_reset (&priv->skip_cache);
 	priv->attr_list = pango_attr_list_new();
 
+	priv->checker = sexy_spell_checker_new ();
+	sexy_spell_checker_activate_default_languages (priv->checker);
+	g_signal_connect (priv->checker, "changed",
+					  G_CALLBACK(sexy_spell_entry_checker_changed), entry);
+
 	priv->checked = TRUE;
 	priv->preedit_length = 0;
 
@@ -644,8 +1128,18 @@ sexy_spell_entry_init(SexySpellEntry *entry)
 					  G_CALLBACK(sexy_spell_entry_populate_popup), NULL);
 	g_signal_connect (G_OBJECT(entry), "changed",
 					  G_CALLBACK(sexy_spell_entry_changed), NULL);
+	g_signal_connect (G_OBJECT(entry), "insert-text",
+					  G_CALLBACK(sexy_spell_entry_before_insert_text), NULL);
+	g_signal_connect_after (G_OBJECT(entry), "insert-text",
+					  G_CALLBACK(sexy_spell_entry_insert_text), NULL);
+	g_signal_connect (G_OBJECT(entry), "delete-text",
+					  G_CALLBACK(sexy_spell_entry_delete_text), NULL);
 	g_signal_connect (G_OBJECT(entry), "preedit-changed",
 					  G_CALLBACK(sexy_spell_entry_preedit_changed), NULL);
+	g_signal_connect (G_OBJECT(entry), "notify::cursor-position",
+					  G_CALLBACK(sexy_spell_entry_cursor_moved), NULL);
+	g_signal_connect (G_OBJECT(entry), "notify::scroll-offset",
+					  G_CALLBACK(sexy_spell_entry_scrolled), NULL);
 }
 
 static void
@@ -662,26 +1156,14 @@ sexy_spell_entry_finalize(GObject *obj)
 
 	if (priv->attr_list)
 		pango_attr_list_unref (priv->attr_list);
-	if (priv->dict_hash)
-		g_hash_table_destroy (priv->dict_hash);
-	free_words(priv);
-
-	if (priv->broker)
-	{
-		GSList *li;
-		for (li = priv->dict_list; li; li = g_slist_next(li))
-		{
-			EnchantDict *dict = (EnchantDict*)li->data;
-			enchant_broker_free_dict (priv->broker, dict);
-		}
-		g_slist_free (priv->dict_list);
-
-		enchant_broker_free (priv->broker);
-	}
+	sexy_word_list_free (priv->words);
+	sexy_word_list_free (priv->fresh_words);
+	sexy_char_index_free (priv->char_index);
+	g_string_free (priv->scratch, TRUE);
+	sexy_span_store_free (priv->misspelled);
 
-	codetable_ref--;
-	if (codetable_ref == 0)
-		codetable_free ();
+	g_signal_handlers_disconnect_by_func (priv->checker, sexy_spell_entry_checker_changed, entry);
+	g_object_unref (priv->checker);
 
 	G_OBJECT_CLASS(sexy_spell_entry_parent_class)->finalize(obj);
 }
@@ -689,8 +1171,39 @@ sexy_spell_entry_finalize(GObject *obj)
 static void
 sexy_spell_entry_dispose(GObject *obj)
 {
+	SexySpellEntryPrivate *priv;
+
 	g_return_if_fail (SEXY_IS_SPELL_ENTRY(obj));
 
+	priv = sexy_spell_entry_get_instance_private (SEXY_SPELL_ENTRY(obj));
+	if (priv->check_timeout_id)
+	{
+		g_source_remove (priv->check_timeout_id);
+		priv->check_timeout_id = 0;
+	}
+	if (priv->check_tick_id)
+	{
+		gtk_widget_remove_tick_callback (GTK_WIDGET(obj), priv->check_tick_id);
+		priv->check_tick_id = 0;
+	}
+	if (priv->check_idle_id)
+	{
+		g_source_remove (priv->check_idle_id);
+		priv->check_idle_id = 0;
+	}
+	if (priv->prefetch_timeout_id)
+	{
+		g_source_remove (priv->prefetch_timeout_id);
+		priv->prefetch_timeout_id = 0;
+	}
+	if (priv->backlog_id)
+	{
+		g_source_remove (priv->backlog_id);
+		priv->backlog_id = 0;
+	}
+
+	sexy_spell_entry_cancel_check (SEXY_SPELL_ENTRY(obj));
+
 	G_OBJECT_CLASS(sexy_spell_entry_parent_class)->dispose(obj);
 }
 
@@ -707,115 +1220,139 @@ sexy_spell_entry_new(void)
 	return GTK_WIDGET(g_object_new (SEXY_TYPE_SPELL_ENTRY, NULL));
 }
 
-GQuark
-sexy_spell_error_quark(void)
-{
-	static GQuark q = 0;
-	if (q == 0)
-		q = g_quark_from_static_string ("sexy-spell-error-quark");
-	return q;
-}
-
 static gboolean
 default_word_check(SexySpellEntry *entry, const gchar *word)
 {
 	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
-	gboolean result = TRUE;
-	GSList *li;
+	gboolean result;
 
-	if (g_unichar_isalpha (*word) == FALSE)
+	if (g_unichar_isalpha (g_utf8_get_char (word)) == FALSE)
 	{
 		/* We only want to check words */
 		return FALSE;
 	}
-	for (li = priv->dict_list; li; li = g_slist_next (li))
+
+	/* Verdicts that just came back from the check thread are not counted
+	 * as cache misses, see sexy_spell_entry_get_cache_stats() */
+	if (priv->fresh_verdicts)
 	{
-		EnchantDict *dict = (EnchantDict*)li->data;
-		if (enchant_dict_check (dict, word, strlen(word)) == 0)
-		{
-			result = FALSE;
-			break;
-		}
+		gpointer value;
+
+		if (g_hash_table_lookup_extended (priv->fresh_verdicts, word, NULL, &value))
+			return GPOINTER_TO_INT(value);
+	}
+
+	if (sexy_spell_checker_cache_lookup (priv->checker, word, &result))
+	{
+		STATS_ADD (priv, cache_hits, 1);
+		return result;
+	}
+
+	if (priv->async_check)
+	{
+		/* Looked up on the check thread, see sexy_spell_entry_queue_check() */
+		priv->deferred = TRUE;
+		return FALSE;
 	}
+
+	STATS_ADD (priv, lookups, 1);
+	result = sexy_spell_checker_lookup (priv->checker, word);
+	sexy_spell_checker_cache_insert (priv->checker, word, result);
 	return result;
 }
 
 static gboolean
 word_misspelled(SexySpellEntry *entry, int start, int end)
 {
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
 	const gchar *text;
-	gchar *word;
 	gboolean ret;
 
 	if (start == end)
 		return FALSE;
 	text = gtk_entry_get_text (GTK_ENTRY(entry));
-	word = g_new0 (gchar, end - start + 2);
+	STATS_ADD (priv, word_checks, 1);
 
-	g_strlcpy (word, text + start, end - start + 1);
+	/* The word is copied to the scratch buffer, unless a handler
+	 * checks another word while this one is being checked */
+	if (priv->in_word_check)
+	{
+		gchar *word = g_strndup (text + start, end - start);
 
-	g_signal_emit (entry, signals[WORD_CHECK], 0, word, &ret);
+		g_signal_emit (entry, signals[WORD_CHECK], 0, word, &ret);
+		g_free (word);
+		return ret;
+	}
+
+	g_string_truncate (priv->scratch, 0);
+	g_string_append_len (priv->scratch, text + start, end - start);
+
+	priv->in_word_check = TRUE;
+	g_signal_emit (entry, signals[WORD_CHECK], 0, priv->scratch->str, &ret);
+	priv->in_word_check = FALSE;
 
-	g_free (word);
 	return ret;
 }
 
 static void
-check_word(SexySpellEntry *entry, int start, int end)
+sexy_spell_entry_check_word(SexySpellEntry *entry, SexyWordList *words, guint index)
 {
-  	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
-	PangoAttrIterator *it;
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+	const gchar *text = gtk_entry_get_text (GTK_ENTRY(entry));
+	gboolean misspelled;
 
-	/* Check to see if we've got any attributes at this position.
-	 * If so, free them, since we'll readd it if the word is misspelled */
-	it = pango_attr_list_get_iterator (priv->attr_list);
-	if (it == NULL)
+	/* URLs, paths and the like are neither copied nor signalled */
+	if (sexy_spell_checker_skips (priv->checker, text, priv->text_length,
+	                              words->starts[index], words->ends[index], &priv->skip_cache))
+	{
+		words->verdicts[index] = SEXY_WORD_CORRECT;
 		return;
-	do {
-		gint s, e;
-		pango_attr_iterator_range(it, &s, &e);
-		if (s == start)
-		{
-			GSList *attrs = pango_attr_iterator_get_attrs (it);
-			g_slist_foreach (attrs, (GFunc)pango_attribute_destroy, NULL);
-			g_slist_free (attrs);
-		}
-	} while (pango_attr_iterator_next(it));
-	pango_attr_iterator_destroy (it);
+	}
 
-	if (word_misspelled (entry, start, end))
-		insert_underline (entry, start, end);
+	priv->deferred = FALSE;
+	misspelled = word_misspelled (entry, words->starts[index], words->ends[index]);
+
+	if (priv->deferred)
+		words->verdicts[index] = SEXY_WORD_PENDING;
+	else
+		words->verdicts[index] = misspelled ? SEXY_WORD_MISSPELLED : SEXY_WORD_CORRECT;
+
+	if (misspelled)
+		sexy_span_store_add (priv->misspelled, words->starts[index], words->ends[index]);
 }
 
 static void
-sexy_spell_entry_recheck_all(SexySpellEntry *entry)
+sexy_spell_entry_build_attributes(SexySpellEntry *entry)
 {
-  	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
-	GdkRectangle rect;
-	GtkWidget *widget = GTK_WIDGET(entry);
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
 	PangoLayout *layout;
-	int i;
-
-	if (priv->checked == FALSE)
-		return;
+	guint i, n_spans;
 
-	if (g_slist_length (priv->dict_list) == 0)
-		return;
-
-	/* Remove all existing pango attributes.  These will get readded as we check */
+	/* Remove all existing pango attributes and readd the misspelled words */
 	pango_attr_list_unref (priv->attr_list);
 	priv->attr_list = pango_attr_list_new ();
 
-	/* Loop through words */
-	for (i = 0; priv->words[i]; i++)
+	n_spans = sexy_span_store_get_n_spans (priv->misspelled);
+	for (i = 0; i < n_spans; i++)
 	{
-		if (!strlen (priv->words[i]))
-			continue;
-		check_word (entry, priv->word_starts[i], priv->word_ends[i]);
+		gint start, end;
+
+		sexy_span_store_get_span (priv->misspelled, i, &start, &end);
+		insert_underline (entry, start, end);
 	}
+	sexy_span_store_clear_changed (priv->misspelled);
 
 	layout = gtk_entry_get_layout (GTK_ENTRY(entry));
 	pango_layout_set_attributes (layout, priv->attr_list);
+}
+
+static void
+sexy_spell_entry_update_attributes(SexySpellEntry *entry)
+{
+	GdkRectangle rect;
+	GtkWidget *widget = GTK_WIDGET(entry);
+
+	sexy_spell_entry_build_attributes (entry);
 
 	if (gtk_widget_get_realized (GTK_WIDGET(entry)))
 	{
@@ -826,6 +1363,184 @@ sexy_spell_entry_recheck_all(SexySpellEntry *entry)
 	}
 }
 
+/* Gets the byte range of the text that is currently scrolled into
+ * view, empty if the entry is not on screen. */
+static void
+get_visible_range(SexySpellEntry *entry, gint *start, gint *end)
+{
+	PangoLayout *layout;
+	PangoLayoutLine *line;
+	GdkRectangle area;
+	gint scroll_offset, index, trailing;
+
+	*start = 0;
+	*end = 0;
+
+	if (!gtk_widget_get_realized (GTK_WIDGET(entry)))
+		return;
+
+	layout = gtk_entry_get_layout (GTK_ENTRY(entry));
+	line = pango_layout_get_line_readonly (layout, 0);
+	if (line == NULL)
+		return;
+
+	gtk_entry_get_text_area (GTK_ENTRY(entry), &area);
+	scroll_offset = get_scroll_offset (entry);
+
+	pango_layout_line_x_to_index (line, scroll_offset * PANGO_SCALE, &index, &trailing);
+	*start = gtk_entry_layout_index_to_text_index (GTK_ENTRY(entry), index);
+
+	pango_layout_line_x_to_index (line, (scroll_offset + area.width) * PANGO_SCALE, &index, &trailing);
+	*end = gtk_entry_layout_index_to_text_index (GTK_ENTRY(entry), index) + 1;
+}
+
+/* Checks the unchecked words of @words that are visible, and returns
+ * whether any are left for the backlog. */
+static gboolean
+sexy_spell_entry_check_visible(SexySpellEntry *entry, SexyWordList *words)
+{
+	gint start, end;
+	guint i, n_unchecked = 0;
+
+	get_visible_range (entry, &start, &end);
+
+	for (i = sexy_word_list_bisect (words->ends, words->len, start);
+	     i < words->len && words->starts[i] < end; i++)
+	{
+		if (words->verdicts[i] == SEXY_WORD_UNCHECKED)
+			sexy_spell_entry_check_word (entry, words, i);
+	}
+
+	for (i = 0; i < words->len && n_unchecked == 0; i++)
+		n_unchecked += words->verdicts[i] == SEXY_WORD_UNCHECKED;
+
+	return n_unchecked > 0;
+}
+
+static gboolean
+sexy_spell_entry_check_backlog(gpointer data)
+{
+	SexySpellEntry *entry = SEXY_SPELL_ENTRY(data);
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+	SexyWordList *words = priv->words;
+	gint64 deadline = g_get_monotonic_time () + CHECK_SLICE_USEC;
+	gboolean done;
+	guint i, n = 0;
+
+	/* Check words until the time for this frame is used up */
+	for (i = priv->backlog_hint; i < words->len; i++)
+	{
+		if (words->verdicts[i] != SEXY_WORD_UNCHECKED)
+			continue;
+
+		sexy_spell_entry_check_word (entry, words, i);
+		if (++n % 16 == 0 && g_get_monotonic_time () >= deadline)
+		{
+			i++;
+			break;
+		}
+	}
+	priv->backlog_hint = i;
+	done = i >= words->len;
+
+	if (priv->async_check && (done || priv->check_job == NULL))
+		sexy_spell_entry_queue_check (entry);
+
+	if (sexy_span_store_get_changed (priv->misspelled))
+		sexy_spell_entry_update_attributes (entry);
+
+	if (!done)
+		return G_SOURCE_CONTINUE;
+
+	priv->backlog_id = 0;
+	return G_SOURCE_REMOVE;
+}
+
+static void
+sexy_spell_entry_schedule_backlog(SexySpellEntry *entry)
+{
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+
+	/* Below the redraw priority, so every slice gets painted */
+	if (priv->backlog_id == 0)
+		priv->backlog_id = g_idle_add (sexy_spell_entry_check_backlog, entry);
+}
+
+static void
+sexy_spell_entry_scrolled(GObject *object, GParamSpec *pspec, gpointer data)
+{
+	SexySpellEntry *entry = SEXY_SPELL_ENTRY(object);
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+
+	/* Don't wait for the backlog to reach what was just scrolled in */
+	if (priv->backlog_id == 0)
+		return;
+
+	sexy_spell_entry_check_visible (entry, priv->words);
+	if (sexy_span_store_get_changed (priv->misspelled))
+		sexy_spell_entry_update_attributes (entry);
+}
+
+static void
+sexy_spell_entry_checker_changed(SexySpellChecker *checker, gpointer data)
+{
+	SexySpellEntry *entry = SEXY_SPELL_ENTRY(data);
+
+	sexy_spell_entry_recheck_all (entry);
+}
+
+static void
+sexy_spell_entry_count_recheck(SexySpellEntry *entry, gint64 start)
+{
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+	gint64 elapsed = g_get_monotonic_time () - start;
+
+	STATS_ADD (priv, rechecks, 1);
+	STATS_ADD (priv, recheck_time, elapsed);
+	priv->stats.recheck_time_max = MAX(priv->stats.recheck_time_max, elapsed);
+	global_stats.recheck_time_max = MAX(global_stats.recheck_time_max, elapsed);
+}
+
+static void
+sexy_spell_entry_recheck_all(SexySpellEntry *entry)
+{
+  	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+	gint64 start;
+
+	/* The skip rules or the whole text may have changed */
+	sexy_skip_cache_reset (&priv->skip_cache);
+
+	if (priv->checked == FALSE)
+		return;
+
+	if (g_slist_length (sexy_spell_checker_get_dicts (priv->checker)) == 0)
+		return;
+
+	start = g_get_monotonic_time ();
+	SEXY_TRACE_BEGIN (recheck_all, entry, gtk_entry_buffer_get_bytes (gtk_entry_get_buffer (GTK_ENTRY(entry))));
+
+	/* Split the whole text again and check every word, the visible
+	 * ones right away */
+	free_words (priv);
+	entry_strsplit_utf8 (entry, 0, -1, priv->words);
+	priv->text_length = (gint) gtk_entry_buffer_get_bytes (gtk_entry_get_buffer (GTK_ENTRY(entry)));
+	priv->damage_full = FALSE;
+	sexy_span_store_reset (priv->misspelled, priv->text_length);
+
+	priv->backlog_hint = 0;
+	if (sexy_spell_entry_check_visible (entry, priv->words))
+		sexy_spell_entry_schedule_backlog (entry);
+
+	if (priv->async_check)
+		sexy_spell_entry_queue_check (entry);
+
+	if (sexy_span_store_get_changed (priv->misspelled))
+		sexy_spell_entry_update_attributes (entry);
+
+	SEXY_TRACE_END (recheck_all, entry, priv->text_length);
+	sexy_spell_entry_count_recheck (entry, start);
+}
+
 static gint
 sexy_spell_entry_draw(GtkWidget *widget, cairo_t *cr)
 {
@@ -836,6 +1551,10 @@ sexy_spell_entry_draw(GtkWidget *widget, cairo_t *cr)
 
 	if (priv->checked)
 	{
+		/* Edits since the last check moved the underlines after them */
+		if (sexy_span_store_get_changed (priv->misspelled))
+			sexy_spell_entry_build_attributes (entry);
+
 		layout = gtk_entry_get_layout (gtk_entry);
 		pango_layout_set_attributes (layout, priv->attr_list);
 	}
@@ -859,8 +1578,8 @@ sexy_spell_entry_style_updated (GtkWidget *widget)
 
 	priv->underline_color = underline_color;
 
-	if (priv->words != NULL)
-		sexy_spell_entry_recheck_all (entry);
+	if (priv->checked && sexy_span_store_get_n_spans (priv->misspelled) > 0)
+		sexy_spell_entry_update_attributes (entry);
 }
 
 static gint
@@ -877,268 +1596,472 @@ sexy_spell_entry_button_press (GtkWidget *widget, GdkEventButton *event)
 }
 
 static gboolean
-sexy_spell_entry_popup_menu (GtkWidget *widget, SexySpellEntry *entry)
+sexy_spell_entry_prefetch_timeout(gpointer data)
 {
+	SexySpellEntry *entry = SEXY_SPELL_ENTRY(data);
 	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
-	/* Menu popped up from a keybinding (menu key or <shift>+F10). Use
-	 * the cursor position as the mark position */
-	priv->mark_character = gtk_editable_get_position (GTK_EDITABLE (entry));
-	return FALSE;
-}
-
-static void
-entry_strsplit_utf8 (GtkEntry *entry, gchar ***set, gint **starts, gint **ends)
-{
-	PangoLayout *layout;
-	const PangoLogAttr *log_attrs;
 	const gchar *text;
-	gint n_attrs = 0, n_strings, i, j;
-	PangoLogAttr a;
+	gchar *word;
+	gint start, end;
+	GSList *li;
+
+	priv->prefetch_timeout_id = 0;
+
+	get_word_extents_from_position (entry, &start, &end, priv->prefetch_position);
+	if (start == end || !sexy_span_store_contains (priv->misspelled, start))
+		return G_SOURCE_REMOVE;
 
-	layout = gtk_entry_get_layout (GTK_ENTRY(entry));
 	text = gtk_entry_get_text (GTK_ENTRY(entry));
-	log_attrs = pango_layout_get_log_attrs_readonly (layout, &n_attrs);
+	word = g_strndup (text + start, end - start);
 
-	/* Find how many words we have */
-	for (i = 0, n_strings = 0; i < n_attrs; i++)
+	for (li = sexy_spell_checker_get_dicts (priv->checker); li; li = g_slist_next (li))
 	{
-		a = log_attrs[i];
-		if (a.is_word_start && a.is_word_boundary)
-			n_strings++;
+		if (sexy_suggestions_lookup (li->data, word) == NULL)
+			sexy_spell_entry_fetch_suggestions (entry, li->data, word);
 	}
 
-	*set = g_new0 (gchar *, n_strings + 1);
-	*starts = g_new0 (gint, n_strings);
-	*ends = g_new0 (gint, n_strings);
+	g_free (word);
+	return G_SOURCE_REMOVE;
+}
+
+/* Fetches the suggestions for the word at @position once the cursor or
+ * pointer stayed there for a moment. */
+static void
+sexy_spell_entry_prefetch(SexySpellEntry *entry, gint position)
+{
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+
+	if (!priv->prefetch_suggestions || !priv->checked)
+		return;
 
-	/* Copy out strings */
-	for (i = 0, j = 0; i < n_attrs; i++)
+	if (priv->prefetch_timeout_id)
 	{
-		a = log_attrs[i];
-		if (a.is_word_start && a.is_word_boundary)
-		{
-			gint cend, bytes;
-			gchar *start;
+		if (priv->prefetch_position == position)
+			return;
+		g_source_remove (priv->prefetch_timeout_id);
+	}
 
-			/* Find the end of this string */
-			for (cend = i; cend < n_attrs; cend++)
-			{
-				a = log_attrs[cend];
-				if (a.is_word_end && a.is_word_boundary)
-					break;
-			}
+	priv->prefetch_position = position;
+	priv->prefetch_timeout_id = g_timeout_add (PREFETCH_DELAY, sexy_spell_entry_prefetch_timeout, entry);
+}
+
+static gboolean
+sexy_spell_entry_motion_notify(GtkWidget *widget, GdkEventMotion *event)
+{
+	SexySpellEntry *entry = SEXY_SPELL_ENTRY(widget);
 
-			/* Copy sub-string */
-			start = g_utf8_offset_to_pointer(text, i);
-			bytes = (gint) (g_utf8_offset_to_pointer(text, cend) - start);
-			(*set)[j] = g_new0(gchar, bytes + 1);
-			(*starts)[j] = (gint) (start - text);
-			(*ends)[j] = (gint) (start - text + bytes);
-			g_utf8_strncpy((*set)[j], start, cend - i);
+	sexy_spell_entry_prefetch (entry, sexy_spell_entry_find_position (entry, event->x));
 
-			/* Move on to the next word */
-			j++;
-		}
-	}
+	return GTK_WIDGET_CLASS(sexy_spell_entry_parent_class)->motion_notify_event (widget, event);
 }
 
 static void
-sexy_spell_entry_changed(GtkEditable *editable, gpointer data)
+sexy_spell_entry_cursor_moved(GObject *object, GParamSpec *pspec, gpointer data)
 {
-	SexySpellEntry *entry = SEXY_SPELL_ENTRY(editable);
-	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
-
-	if (priv->checked == FALSE)
-		return;
-	if (g_slist_length(priv->dict_list) == 0)
-		return;
+	SexySpellEntry *entry = SEXY_SPELL_ENTRY(object);
 
-	free_words(priv);
-	entry_strsplit_utf8(GTK_ENTRY(entry), &priv->words,
-						&priv->word_starts, &priv->word_ends);
-	sexy_spell_entry_recheck_all(entry);
+	sexy_spell_entry_prefetch (entry, gtk_editable_get_position (GTK_EDITABLE(entry)));
 }
 
 static gboolean
-enchant_has_lang(const gchar *lang, GSList *langs)
+sexy_spell_entry_popup_menu (GtkWidget *widget, SexySpellEntry *entry)
 {
-	GSList *i;
-	for (i = langs; i; i = g_slist_next(i))
-	{
-		if (strcmp(lang, i->data) == 0)
-			return TRUE;
-	}
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+	/* Menu popped up from a keybinding (menu key or <shift>+F10). Use
+	 * the cursor position as the mark position */
+	priv->mark_character = gtk_editable_get_position (GTK_EDITABLE (entry));
 	return FALSE;
 }
 
+static void
+entry_strsplit_utf8 (SexySpellEntry *entry, gint start, gint end, SexyWordList *words)
+{
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+	GtkEntryBuffer *buffer = gtk_entry_get_buffer (GTK_ENTRY(entry));
+	gint text_length = (gint) gtk_entry_buffer_get_bytes (buffer);
+	guint n_words = words->len;
+
+	/* Append the words starting inside [start, end) */
+	if (end < 0)
+		end = text_length;
+	SEXY_TRACE_BEGIN (tokenize, entry, end - start);
+	sexy_tokenize (gtk_entry_buffer_get_text (buffer), text_length, start, end, words);
+	SEXY_TRACE_END (tokenize, entry, end - start);
+	STATS_ADD (priv, words_tokenized, words->len - n_words);
+}
 
-static GSList *
-get_default_spell_languages (void)
+static void
+sexy_spell_entry_text_edited (SexySpellEntry *entry, gint pos, gint n_deleted, gint n_inserted)
 {
-	const gchar* const *langs = g_get_language_names ();
-	GSList *lang_list = NULL;
-	char *last = NULL;
-	char *p;
-	int i;
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+	gint delta = n_inserted - n_deleted;
+	gint damage_start = pos;
+	gint damage_end = pos + n_inserted;
+	guint i, first = 0, n_touched = 0;
+
+	priv->text_length += delta;
+	sexy_skip_cache_reset (&priv->skip_cache);
+	sexy_span_store_edit (priv->misspelled, pos, n_deleted, n_inserted);
+	sexy_char_index_invalidate (priv->char_index, pos);
 
-	if (langs != NULL)
+	if (priv->damage_full)
+		return;
+
+	/* Drop the words touched by the edit, they get split again on
+	 * "changed". Everything after it only moves. */
+	for (i = sexy_word_list_bisect (priv->words->ends, priv->words->len, pos); i < priv->words->len; i++)
 	{
-		for (i = 0; langs[i]; i++)
+		if (priv->words->starts[i] <= pos + n_deleted)
 		{
-			if (g_ascii_strncasecmp (langs[i], "C", 1) != 0 && strlen (langs[i]) >= 2)
-			{
-				/* Avoid duplicates, "en" and "en_US" for example. */
-				if (!last || !g_str_has_prefix (langs[i], last))
-				{
-					if (last != NULL)
-						g_free(last);
+			if (n_touched++ == 0)
+				first = i;
+			damage_start = MIN(damage_start, priv->words->starts[i]);
+			damage_end = MAX(damage_end, priv->words->ends[i] + delta);
+		}
+		else
+		{
+			priv->words->starts[i] += delta;
+			priv->words->ends[i] += delta;
+		}
+	}
 
-					/* ignore .utf8 */
-					if ((p = strchr (langs[i], '.')))
-						*p='\0';
+	if (n_touched)
+	{
+		sexy_word_list_remove_range (priv->words, first, n_touched);
+		priv->backlog_hint = MIN(priv->backlog_hint, first);
+	}
 
-					last = g_strndup (langs[i], 2);
+	/* Merge with the damage of earlier edits, mapped into the new text */
+	if (priv->damage_start >= 0)
+	{
+		gint s = priv->damage_start;
+		gint e = priv->damage_end;
 
-					lang_list = g_slist_append (lang_list, (char*)langs[i]);
-				}
-			}
-		}
-		if (last != NULL)
-			g_free(last);
+		if (s > pos)
+			s = (s >= pos + n_deleted) ? s + delta : pos;
+		if (e > pos)
+			e = (e >= pos + n_deleted) ? e + delta : pos;
+
+		damage_start = MIN(damage_start, s);
+		damage_end = MAX(damage_end, e);
 	}
 
-	return lang_list;
+	priv->damage_start = damage_start;
+	priv->damage_end = damage_end;
 }
 
-/**
- * sexy_spell_entry_activate_default_languages:
- * @entry: A #SexySpellEntry.
- *
- * Activate spell checking for languages specified in the $LANG
- * or $LANGUAGE environment variables. If none is found it defaults to "en".
- * These languages are activated by default, so this function need only
- * be called if they were previously deactivated.
- */
-void
-sexy_spell_entry_activate_default_languages(SexySpellEntry *entry)
+/* Whether the text only changed through the editable signals since it
+ * was last tracked. If it did not, the offsets kept for it are off, and
+ * check_damage() finds the length mismatch and checks everything. */
+static gboolean
+sexy_spell_entry_tracking (SexySpellEntry *entry)
 {
 	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
-	GSList *enchant_langs, *langs, *lang_item;
-	char *lang;
-
-	if (!priv->broker)
-		priv->broker = enchant_broker_init();
-
-	enchant_langs = sexy_spell_entry_get_languages(entry);
-	langs = get_default_spell_languages();
-	if (langs)
-	{
-		lang_item = langs;
-		while (lang_item != NULL)
-		{
-			lang = (char*)lang_item->data;
-			if (enchant_has_lang (lang, enchant_langs))
-			{
-				sexy_spell_entry_activate_language_internal (entry, lang, NULL);
-			}
-			lang_item = g_slist_next(lang_item);
-		}
-		g_slist_free (langs);
-	}
-	g_slist_free_full (enchant_langs, g_free);
 
-	/* If we don't have any languages activated, use "en" */
-	if (priv->dict_list == NULL)
-		sexy_spell_entry_activate_language_internal(entry, "en", NULL);
+	if (priv->text_length == (gint) gtk_entry_buffer_get_bytes (gtk_entry_get_buffer (GTK_ENTRY(entry))))
+		return TRUE;
 
-	sexy_spell_entry_recheck_all (entry);
+	sexy_char_index_invalidate (priv->char_index, 0);
+	return FALSE;
 }
 
 static void
-get_lang_from_dict_cb(const char * const lang_tag,
-		      const char * const provider_name,
-		      const char * const provider_desc,
-		      const char * const provider_file,
-		      void * user_data)
+sexy_spell_entry_before_insert_text (GtkEditable *editable, gchar *new_text, gint new_text_length,
+                                     gint *position, gpointer data)
 {
-	gchar **lang = (gchar **)user_data;
-	*lang = g_strdup(lang_tag);
+	SexySpellEntry *entry = SEXY_SPELL_ENTRY(editable);
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+
+	priv->insert_pos = -1;
+	if (!sexy_spell_entry_tracking (entry))
+		return;
+
+	priv->insert_pos = sexy_char_index_char_to_byte (priv->char_index,
+	                                                 gtk_entry_get_text (GTK_ENTRY(entry)),
+	                                                 *position < 0 ? G_MAXINT : *position);
 }
 
-static gchar *
-get_lang_from_dict(EnchantDict *dict)
+static void
+sexy_spell_entry_insert_text (GtkEditable *editable, gchar *new_text, gint new_text_length,
+                              gint *position, gpointer data)
 {
-	gchar *lang;
+	SexySpellEntry *entry = SEXY_SPELL_ENTRY(editable);
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+	gint n_inserted;
+
+	if (priv->insert_pos < 0)
+		return;
 
-	enchant_dict_describe(dict, get_lang_from_dict_cb, &lang);
-	return lang;
+	/* GtkEntry may have truncated the text to its maximum length, so
+	 * take what the buffer grew by, which is only this insert as the
+	 * lengths agreed before it. Anything else changing the buffer in
+	 * between shows up as a mismatch and is left to the full check. */
+	if (new_text_length < 0)
+		new_text_length = (gint) strlen (new_text);
+	n_inserted = (gint) gtk_entry_buffer_get_bytes (gtk_entry_get_buffer (GTK_ENTRY(entry))) - priv->text_length;
+	n_inserted = MIN(n_inserted, new_text_length);
+	if (n_inserted > 0)
+		sexy_spell_entry_text_edited (entry, priv->insert_pos, 0, n_inserted);
+
+	priv->insert_pos = -1;
 }
 
-static gboolean
-sexy_spell_entry_activate_language_internal(SexySpellEntry *entry, const gchar *lang, GError **error)
+static void
+sexy_spell_entry_delete_text (GtkEditable *editable, gint start_pos, gint end_pos, gpointer data)
 {
+	SexySpellEntry *entry = SEXY_SPELL_ENTRY(editable);
 	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
-	EnchantDict *dict;
-
-	if (!priv->broker)
-		priv->broker = enchant_broker_init();
+	const gchar *text;
+	gint n_chars, start, end;
 
-	if (g_hash_table_lookup(priv->dict_hash, lang))
-		return TRUE;
+	if (!sexy_spell_entry_tracking (entry))
+		return;
 
-	dict = enchant_broker_request_dict(priv->broker, lang);
+	text = gtk_entry_get_text (GTK_ENTRY(entry));
+	n_chars = gtk_entry_get_text_length (GTK_ENTRY(entry));
 
-	if (!dict)
-	{
-		g_set_error(error, SEXY_SPELL_ERROR, SEXY_SPELL_ERROR_BACKEND, _("enchant error for language: %s"), lang);
-		return FALSE;
-	}
+	if (end_pos < 0 || end_pos > n_chars)
+		end_pos = n_chars;
+	start_pos = CLAMP(start_pos, 0, end_pos);
+	if (start_pos == end_pos)
+		return;
 
-	priv->dict_list = g_slist_append(priv->dict_list, (gpointer) dict);
-	g_hash_table_insert(priv->dict_hash, get_lang_from_dict(dict), (gpointer) dict);
+	start = sexy_char_index_char_to_byte (priv->char_index, text, start_pos);
+	end = sexy_char_index_char_to_byte (priv->char_index, text, end_pos);
 
-	return TRUE;
+	sexy_spell_entry_text_edited (entry, start, end - start, 0);
 }
 
+/* Words are joined across punctuation like "don't" or "a.b", by the
+ * tokenizer and by Pango, so an edit can merge or split the words next
+ * to it even when it does not touch them. The damage is therefore taken
+ * to the whole run of non-space characters around it. */
 static void
-dict_describe_cb(const char * const lang_tag,
-		 const char * const provider_name,
-		 const char * const provider_desc,
-		 const char * const provider_file,
-		 void * user_data)
+sexy_spell_entry_widen_damage(SexySpellEntry *entry)
 {
-	GSList **langs = (GSList **)user_data;
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+	const gchar *text = gtk_entry_get_text (GTK_ENTRY(entry));
+	const gchar *start = text + priv->damage_start;
+	const gchar *end = text + priv->damage_end;
+	const gchar *prev;
+
+	while (start > text)
+	{
+		prev = g_utf8_find_prev_char (text, start);
+		if (g_unichar_isspace (g_utf8_get_char (prev)))
+			break;
+		start = prev;
+	}
+
+	while (end < text + priv->text_length && !g_unichar_isspace (g_utf8_get_char (end)))
+		end = g_utf8_next_char (end);
 
-	*langs = g_slist_append(*langs, (gpointer)g_strdup(lang_tag));
+	priv->damage_start = (gint) (start - text);
+	priv->damage_end = (gint) (end - text);
 }
 
-/**
- * sexy_spell_entry_get_languages:
- * @entry: A #SexySpellEntry.
- *
- * Retrieve a list of language codes for which dictionaries are available.
- *
- * Returns: (transfer full) (element-type utf8): a new #GList object, or %NULL on error.
- *          Should be freed with g_slist_free_full() and g_free().
- */
-GSList *
-sexy_spell_entry_get_languages(const SexySpellEntry *entry)
+/* Edits far apart are merged into one damaged range, with words no edit
+ * touched left in between. Those are dropped as well, so splitting the
+ * range again does not add them twice, and the range grows to cover any
+ * word it cuts into. */
+static void
+sexy_spell_entry_drop_damaged_words(SexySpellEntry *entry)
 {
 	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
-	GSList *langs = NULL;
-
-	g_return_val_if_fail(entry != NULL, NULL);
-	g_return_val_if_fail(SEXY_IS_SPELL_ENTRY(entry), NULL);
+	SexyWordList *words = priv->words;
+	guint first, last, i;
 
-	if (!priv->broker)
-		return NULL;
+	first = sexy_word_list_bisect (words->ends, words->len, priv->damage_start + 1);
+	last = sexy_word_list_bisect (words->starts, words->len, priv->damage_end);
+	if (first >= last)
+		return;
 
-	enchant_broker_list_dicts(priv->broker, dict_describe_cb, &langs);
+	priv->damage_start = MIN(priv->damage_start, words->starts[first]);
+	priv->damage_end = MAX(priv->damage_end, words->ends[last - 1]);
 
-	return langs;
+	for (i = first; i < last; i++)
+		sexy_span_store_remove (priv->misspelled, words->starts[i]);
+	sexy_word_list_remove_range (words, first, last - first);
+	priv->backlog_hint = MIN(priv->backlog_hint, first);
 }
 
-/**
+static void
+sexy_spell_entry_check_damage(SexySpellEntry *entry)
+{
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+	SexyWordList *fresh;
+	gboolean unchecked;
+	guint first;
+	gint64 start;
+
+	if (priv->checked == FALSE || g_slist_length(sexy_spell_checker_get_dicts (priv->checker)) == 0)
+	{
+		free_words (priv);
+		return;
+	}
+
+	/* The buffer was changed behind our back (i.e. gtk_entry_set_buffer()),
+	 * so the tracked offsets can't be trusted. */
+	if (priv->damage_full ||
+	    priv->text_length != (gint) gtk_entry_buffer_get_bytes (gtk_entry_get_buffer (GTK_ENTRY(entry))))
+	{
+		sexy_spell_entry_recheck_all (entry);
+		return;
+	}
+
+	if (priv->damage_start < 0)
+		return;
+
+	start = g_get_monotonic_time ();
+	SEXY_TRACE_BEGIN (check, entry, priv->text_length);
+
+	/* Split and check only the damaged range */
+	sexy_spell_entry_widen_damage (entry);
+	sexy_spell_entry_drop_damaged_words (entry);
+	fresh = priv->fresh_words;
+	sexy_word_list_clear (fresh);
+	entry_strsplit_utf8 (entry, priv->damage_start, priv->damage_end, fresh);
+	unchecked = sexy_spell_entry_check_visible (entry, fresh);
+
+	first = sexy_word_list_bisect (priv->words->starts, priv->words->len, priv->damage_start);
+	sexy_word_list_insert (priv->words, first, fresh);
+
+	/* A large paste is finished off in the background */
+	if (unchecked)
+	{
+		priv->backlog_hint = MIN(priv->backlog_hint, first);
+		sexy_spell_entry_schedule_backlog (entry);
+	}
+
+	priv->damage_start = -1;
+	priv->damage_end = -1;
+
+	/* Restart the lookup, the words it was given may be gone by now */
+	if (priv->async_check)
+		sexy_spell_entry_queue_check (entry);
+
+	/* Moving the text after the last misspelling does not move any
+	 * underline, so the attributes only need rebuilding when a span was
+	 * added, removed or shifted. */
+	if (sexy_span_store_get_changed (priv->misspelled))
+		sexy_spell_entry_update_attributes (entry);
+
+	SEXY_TRACE_END (check, entry, priv->text_length);
+	sexy_spell_entry_count_recheck (entry, start);
+}
+
+static gboolean
+sexy_spell_entry_check_tick(GtkWidget *widget, GdkFrameClock *frame_clock, gpointer data)
+{
+	SexySpellEntry *entry = SEXY_SPELL_ENTRY(widget);
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+
+	priv->check_tick_id = 0;
+	sexy_spell_entry_check_damage (entry);
+
+	return G_SOURCE_REMOVE;
+}
+
+static gboolean
+sexy_spell_entry_check_idle(gpointer data)
+{
+	SexySpellEntry *entry = SEXY_SPELL_ENTRY(data);
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+
+	priv->check_idle_id = 0;
+	sexy_spell_entry_check_damage (entry);
+
+	return G_SOURCE_REMOVE;
+}
+
+/* Checks everything changed so far in one go: before the next frame is
+ * painted, or when idle if the entry is not on screen. A paste or
+ * replace_word() emits several "changed" in a row. */
+static void
+sexy_spell_entry_schedule_check(SexySpellEntry *entry)
+{
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+	GtkWidget *widget = GTK_WIDGET(entry);
+
+	if (priv->check_tick_id || priv->check_idle_id)
+		return;
+
+	if (gtk_widget_get_realized (widget))
+		priv->check_tick_id = gtk_widget_add_tick_callback (widget, sexy_spell_entry_check_tick, NULL, NULL);
+	else
+		priv->check_idle_id = g_idle_add (sexy_spell_entry_check_idle, entry);
+}
+
+static gboolean
+sexy_spell_entry_check_timeout(gpointer data)
+{
+	SexySpellEntry *entry = SEXY_SPELL_ENTRY(data);
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+
+	priv->check_timeout_id = 0;
+	sexy_spell_entry_schedule_check (entry);
+
+	return G_SOURCE_REMOVE;
+}
+
+static void
+sexy_spell_entry_changed(GtkEditable *editable, gpointer data)
+{
+	SexySpellEntry *entry = SEXY_SPELL_ENTRY(editable);
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+
+	if (priv->check_delay == 0)
+	{
+		sexy_spell_entry_schedule_check (entry);
+		return;
+	}
+
+	if (priv->check_timeout_id)
+		g_source_remove (priv->check_timeout_id);
+	priv->check_timeout_id = g_timeout_add (priv->check_delay, sexy_spell_entry_check_timeout, entry);
+}
+
+/**
+ * sexy_spell_entry_activate_default_languages:
+ * @entry: A #SexySpellEntry.
+ *
+ * Activate spell checking for languages specified in the $LANG
+ * or $LANGUAGE environment variables. If none is found it defaults to "en".
+ * These languages are activated by default, so this function need only
+ * be called if they were previously deactivated.
+ */
+void
+sexy_spell_entry_activate_default_languages(SexySpellEntry *entry)
+{
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+
+	g_return_if_fail (SEXY_IS_SPELL_ENTRY(entry));
+
+	sexy_spell_checker_activate_default_languages (priv->checker);
+}
+
+/**
+ * sexy_spell_entry_get_languages:
+ * @entry: A #SexySpellEntry.
+ *
+ * Retrieve a list of language codes for which dictionaries are available.
+ *
+ * Returns: (transfer full) (element-type utf8): a new #GList object, or %NULL on error.
+ *          Should be freed with g_slist_free_full() and g_free().
+ */
+GSList *
+sexy_spell_entry_get_languages(const SexySpellEntry *entry)
+{
+	SexySpellEntryPrivate *priv;
+
+	g_return_val_if_fail(entry != NULL, NULL);
+	g_return_val_if_fail(SEXY_IS_SPELL_ENTRY(entry), NULL);
+
+	priv = sexy_spell_entry_get_instance_private ((SexySpellEntry *) entry);
+	return sexy_spell_checker_get_languages (priv->checker);
+}
+
+/**
  * sexy_spell_entry_get_language_name:
  * @entry: A #SexySpellEntry.
  * @lang: The language code to lookup a friendly name for.
@@ -1154,14 +2077,8 @@ sexy_spell_entry_get_language_name(const SexySpellEntry *entry,
 	const gchar *lang_name = "";
 	const gchar *country_name = "";
 
-	if (codetable_ref == 0)
-		codetable_init ();
-
 	codetable_lookup (lang, &lang_name, &country_name);
 
-	if (codetable_ref == 0)
-		codetable_free ();
-
 	if (strlen (country_name) != 0)
 		return g_strdup_printf ("%s (%s)", lang_name, country_name);
 	else
@@ -1181,8 +2098,8 @@ gboolean
 sexy_spell_entry_language_is_active(const SexySpellEntry *entry,
 									const gchar *lang)
 {
-	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
-	return (g_hash_table_lookup(priv->dict_hash, lang) != NULL);
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private ((SexySpellEntry *) entry);
+	return sexy_spell_checker_language_is_active (priv->checker, lang);
 }
 
 /**
@@ -1200,26 +2117,11 @@ gboolean
 sexy_spell_entry_activate_language(SexySpellEntry *entry, const gchar *lang, GError **error)
 {
 	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
-	gboolean ret;
 
 	g_return_val_if_fail(entry != NULL, FALSE);
 	g_return_val_if_fail(SEXY_IS_SPELL_ENTRY(entry), FALSE);
-	g_return_val_if_fail(lang != NULL && lang != '\0', FALSE);
-
-	if (error)
-		g_return_val_if_fail(*error == NULL, FALSE);
-
-	ret = sexy_spell_entry_activate_language_internal (entry, lang, error);
-
-	if (ret)
-	{
-		free_words (priv);
-		entry_strsplit_utf8 (GTK_ENTRY(entry), &priv->words,
-							&priv->word_starts, &priv->word_ends);
-		sexy_spell_entry_recheck_all (entry);
-	}
 
-	return ret;
+	return sexy_spell_checker_activate_language (priv->checker, lang, error);
 }
 
 /**
@@ -1238,42 +2140,7 @@ sexy_spell_entry_deactivate_language(SexySpellEntry *entry, const gchar *lang)
 	g_return_if_fail (entry != NULL);
 	g_return_if_fail (SEXY_IS_SPELL_ENTRY(entry));
 
-	if (!priv->dict_list)
-		return;
-
-	if (lang)
-	{
-		EnchantDict *dict;
-
-		dict = g_hash_table_lookup (priv->dict_hash, lang);
-		if (!dict)
-			return;
-		enchant_broker_free_dict(priv->broker, dict);
-		priv->dict_list = g_slist_remove (priv->dict_list, dict);
-		g_hash_table_remove (priv->dict_hash, lang);
-	}
-	else
-	{
-		/* deactivate all */
-		GSList *li;
-		EnchantDict *dict;
-
-		for (li = priv->dict_list; li; li = g_slist_next (li))
-		{
-			dict = (EnchantDict*)li->data;
-			enchant_broker_free_dict (priv->broker, dict);
-		}
-
-		g_slist_free (priv->dict_list);
-		g_hash_table_destroy (priv->dict_hash);
-		priv->dict_hash = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
-		priv->dict_list = NULL;
-	}
-
-	free_words (priv);
-	entry_strsplit_utf8 (GTK_ENTRY(entry), &priv->words,
-						&priv->word_starts, &priv->word_ends);
-	sexy_spell_entry_recheck_all (entry);
+	sexy_spell_checker_deactivate_language (priv->checker, lang);
 }
 
 /**
@@ -1292,26 +2159,124 @@ gboolean
 sexy_spell_entry_set_active_languages(SexySpellEntry *entry, GSList *langs, GError **error)
 {
 	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
-	GSList *li;
 
 	g_return_val_if_fail (entry != NULL, FALSE);
 	g_return_val_if_fail (SEXY_IS_SPELL_ENTRY(entry), FALSE);
-	g_return_val_if_fail (langs != NULL, FALSE);
 
-	/* deactivate all languages first */
-	sexy_spell_entry_deactivate_language (entry, NULL);
+	return sexy_spell_checker_set_active_languages (priv->checker, langs, error);
+}
 
-	for (li = langs; li; li = g_slist_next (li))
-	{
-		if (sexy_spell_entry_activate_language_internal (entry,
-				(const gchar*)li->data, error) == FALSE)
-			return FALSE;
-	}
-	free_words (priv);
-	entry_strsplit_utf8 (GTK_ENTRY(entry), &priv->words,
-						 &priv->word_starts, &priv->word_ends);
-	sexy_spell_entry_recheck_all (entry);
-	return TRUE;
+/* The checker reports to the entry's task, so callers get the entry as
+ * the source object */
+static void
+languages_loaded_cb(GObject *source_object, GAsyncResult *result, gpointer user_data)
+{
+	GTask *task = G_TASK(user_data);
+	GError *error = NULL;
+
+	if (g_task_propagate_boolean (G_TASK(result), &error))
+		g_task_return_boolean (task, TRUE);
+	else
+		g_task_return_error (task, error);
+	g_object_unref (task);
+}
+
+/**
+ * sexy_spell_entry_activate_language_async:
+ * @entry: A #SexySpellEntry
+ * @lang: The language to use in a form Enchant understands. Typically either
+ *        a two letter language code or a locale code in the form xx_XX.
+ * @cancellable: (nullable): A #GCancellable.
+ * @callback: Called when the language is active.
+ * @user_data: Data passed to @callback.
+ *
+ * Asynchronous version of sexy_spell_entry_activate_language(). The
+ * dictionary is loaded in a worker thread, the entry keeps checking with
+ * the currently active languages until it is ready.
+ *
+ * Since: 1.2
+ */
+void
+sexy_spell_entry_activate_language_async(SexySpellEntry *entry, const gchar *lang, GCancellable *cancellable,
+                                         GAsyncReadyCallback callback, gpointer user_data)
+{
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+	GTask *task;
+
+	g_return_if_fail (SEXY_IS_SPELL_ENTRY(entry));
+
+	task = g_task_new (entry, cancellable, callback, user_data);
+	g_task_set_source_tag (task, sexy_spell_entry_activate_language_async);
+	sexy_spell_checker_activate_language_async (priv->checker, lang, cancellable, languages_loaded_cb, task);
+}
+
+/**
+ * sexy_spell_entry_activate_language_finish:
+ * @entry: A #SexySpellEntry
+ * @result: The #GAsyncResult passed to the callback.
+ * @error: Return location for error.
+ *
+ * Finishes sexy_spell_entry_activate_language_async().
+ *
+ * Returns: %FALSE if there was an error.
+ * Since: 1.2
+ */
+gboolean
+sexy_spell_entry_activate_language_finish(SexySpellEntry *entry, GAsyncResult *result, GError **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, entry), FALSE);
+
+	return g_task_propagate_boolean (G_TASK(result), error);
+}
+
+/**
+ * sexy_spell_entry_set_active_languages_async:
+ * @entry: A #SexySpellEntry
+ * @langs: (element-type utf8): A list of language codes to activate,
+ *         in a form Enchant understands. Typically either a two letter
+ *         language code or a locale code in the form xx_XX.
+ * @cancellable: (nullable): A #GCancellable.
+ * @callback: Called when the languages are active.
+ * @user_data: Data passed to @callback.
+ *
+ * Asynchronous version of sexy_spell_entry_set_active_languages(). All
+ * dictionaries are loaded in a worker thread and replace the active ones
+ * in one go. If any of them fails to load the active languages are left
+ * untouched.
+ *
+ * Since: 1.2
+ */
+void
+sexy_spell_entry_set_active_languages_async(SexySpellEntry *entry, GSList *langs, GCancellable *cancellable,
+                                            GAsyncReadyCallback callback, gpointer user_data)
+{
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+	GTask *task;
+
+	g_return_if_fail (SEXY_IS_SPELL_ENTRY(entry));
+
+	task = g_task_new (entry, cancellable, callback, user_data);
+	g_task_set_source_tag (task, sexy_spell_entry_set_active_languages_async);
+	sexy_spell_checker_set_active_languages_async (priv->checker, langs, cancellable, languages_loaded_cb, task);
+}
+
+/**
+ * sexy_spell_entry_set_active_languages_finish:
+ * @entry: A #SexySpellEntry
+ * @result: The #GAsyncResult passed to the callback.
+ * @error: Return location for error.
+ *
+ * Finishes sexy_spell_entry_set_active_languages_async().
+ *
+ * Returns: %FALSE if there was an error.
+ * Since: 1.2
+ */
+gboolean
+sexy_spell_entry_set_active_languages_finish(SexySpellEntry *entry, GAsyncResult *result, GError **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, entry), FALSE);
+
+	return g_task_propagate_boolean (G_TASK(result), error);
 }
 
 /**
@@ -1327,20 +2292,11 @@ GSList *
 sexy_spell_entry_get_active_languages(SexySpellEntry *entry)
 {
 	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
-	GSList *ret = NULL, *li;
-	EnchantDict *dict;
-	gchar *lang;
 
 	g_return_val_if_fail (entry != NULL, NULL);
 	g_return_val_if_fail (SEXY_IS_SPELL_ENTRY(entry), NULL);
 
-	for (li = priv->dict_list; li; li = g_slist_next (li))
-	{
-		dict = (EnchantDict*)li->data;
-		lang = get_lang_from_dict (dict);
-		ret = g_slist_append (ret, lang);
-	}
-	return ret;
+	return sexy_spell_checker_get_active_languages (priv->checker);
 }
 
 /**
@@ -1410,9 +2366,444 @@ sexy_spell_entry_set_checked(SexySpellEntry *entry, gboolean checked)
 		gdk_window_invalidate_rect (gtk_widget_get_window(widget), &rect, TRUE);
 	}
 	else
+		sexy_spell_entry_recheck_all (entry);
+}
+
+/**
+ * sexy_spell_entry_get_cache_size:
+ * @entry: A #SexySpellEntry.
+ *
+ * Gets the number of dictionary verdicts the entry remembers.
+ *
+ * Returns: The size of the verdict cache.
+ * Since: 1.2
+ */
+guint
+sexy_spell_entry_get_cache_size(SexySpellEntry *entry)
+{
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+
+	g_return_val_if_fail (SEXY_IS_SPELL_ENTRY(entry), 0);
+
+	return sexy_spell_checker_get_cache_size (priv->checker);
+}
+
+/**
+ * sexy_spell_entry_set_cache_size:
+ * @entry: A #SexySpellEntry.
+ * @size: Number of verdicts to remember, 0 to disable the cache.
+ *
+ * Sets the number of dictionary verdicts the entry remembers.
+ *
+ * Since: 1.2
+ */
+void
+sexy_spell_entry_set_cache_size(SexySpellEntry *entry, guint size)
+{
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+
+	g_return_if_fail (SEXY_IS_SPELL_ENTRY(entry));
+
+	if (sexy_spell_checker_get_cache_size (priv->checker) == size)
+		return;
+
+	sexy_spell_checker_set_cache_size (priv->checker, size);
+	g_object_notify (G_OBJECT(entry), "cache-size");
+}
+
+/**
+ * sexy_spell_entry_get_cache_stats:
+ * @entry: A #SexySpellEntry.
+ * @hits: (out) (optional): Return location for the number of lookups
+ *        answered from the cache.
+ * @misses: (out) (optional): Return location for the number of lookups
+ *          that had to go to the dictionaries.
+ *
+ * Retrieves the verdict cache statistics, which can be used to pick
+ * a #SexySpellEntry:cache-size.
+ *
+ * Since: 1.2
+ */
+void
+sexy_spell_entry_get_cache_stats(SexySpellEntry *entry, guint *hits, guint *misses)
+{
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+
+	g_return_if_fail (SEXY_IS_SPELL_ENTRY(entry));
+
+	sexy_spell_checker_get_cache_stats (priv->checker, hits, misses);
+}
+
+/**
+ * sexy_spell_entry_get_stats:
+ * @entry: A #SexySpellEntry.
+ * @stats: (out caller-allocates): Return location for the statistics.
+ *
+ * Retrieves how much spell checking work @entry did since it was
+ * created or since the last sexy_spell_entry_reset_stats(). Counting
+ * costs a few additions per check and is always on.
+ *
+ * Suggestions are only counted for the entry that asked for them first,
+ * and lookups done by sexy_spell_checker_check_text() and friends are
+ * not counted at all.
+ *
+ * Since: 1.2
+ */
+void
+sexy_spell_entry_get_stats(SexySpellEntry *entry, SexySpellStats *stats)
+{
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+
+	g_return_if_fail (SEXY_IS_SPELL_ENTRY(entry));
+	g_return_if_fail (stats != NULL);
+
+	*stats = priv->stats;
+}
+
+/**
+ * sexy_spell_entry_reset_stats:
+ * @entry: A #SexySpellEntry.
+ *
+ * Sets the statistics of @entry back to zero. The process-wide ones are
+ * left alone.
+ *
+ * Since: 1.2
+ */
+void
+sexy_spell_entry_reset_stats(SexySpellEntry *entry)
+{
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+
+	g_return_if_fail (SEXY_IS_SPELL_ENTRY(entry));
+
+	memset (&priv->stats, 0, sizeof (priv->stats));
+}
+
+/**
+ * sexy_spell_entry_get_global_stats:
+ * @stats: (out caller-allocates): Return location for the statistics.
+ *
+ * Retrieves the statistics of all entries together, including the ones
+ * already destroyed, since the start of the process or the last
+ * sexy_spell_entry_reset_global_stats(). Must be called from the main
+ * thread.
+ *
+ * Since: 1.2
+ */
+void
+sexy_spell_entry_get_global_stats(SexySpellStats *stats)
+{
+	g_return_if_fail (stats != NULL);
+
+	*stats = global_stats;
+}
+
+/**
+ * sexy_spell_entry_reset_global_stats:
+ *
+ * Sets the process-wide statistics back to zero, for instance after
+ * exporting them. The statistics of each entry are left alone.
+ *
+ * Since: 1.2
+ */
+void
+sexy_spell_entry_reset_global_stats(void)
+{
+	memset (&global_stats, 0, sizeof (global_stats));
+}
+
+/**
+ * sexy_spell_entry_get_async_check:
+ * @entry: A #SexySpellEntry.
+ *
+ * Gets whether dictionary lookups are done on a worker thread.
+ *
+ * Returns: %TRUE if checking is asynchronous.
+ *
+ * Since: 1.2
+ */
+gboolean
+sexy_spell_entry_get_async_check(SexySpellEntry *entry)
+{
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+
+	g_return_val_if_fail (SEXY_IS_SPELL_ENTRY(entry), FALSE);
+
+	return priv->async_check;
+}
+
+/**
+ * sexy_spell_entry_set_async_check:
+ * @entry: A #SexySpellEntry.
+ * @async_check: %TRUE to look words up on a worker thread.
+ *
+ * Sets whether dictionary lookups are done on a worker thread, see
+ * #SexySpellEntry:async-check.
+ *
+ * Since: 1.2
+ */
+void
+sexy_spell_entry_set_async_check(SexySpellEntry *entry, gboolean async_check)
+{
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+
+	g_return_if_fail (SEXY_IS_SPELL_ENTRY(entry));
+
+	async_check = !!async_check;
+	if (priv->async_check == async_check)
+		return;
+
+	priv->async_check = async_check;
+	if (!async_check)
 	{
-		free_words (priv);
-		entry_strsplit_utf8 (GTK_ENTRY(entry), &priv->words, &priv->word_starts, &priv->word_ends);
+		sexy_spell_entry_cancel_check (entry);
 		sexy_spell_entry_recheck_all (entry);
 	}
+
+	g_object_notify (G_OBJECT(entry), "async-check");
+}
+
+/**
+ * sexy_spell_entry_get_check_delay:
+ * @entry: A #SexySpellEntry.
+ *
+ * Gets the time to wait after a change before checking the text.
+ *
+ * Returns: The delay in milliseconds.
+ *
+ * Since: 1.2
+ */
+guint
+sexy_spell_entry_get_check_delay(SexySpellEntry *entry)
+{
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+
+	g_return_val_if_fail (SEXY_IS_SPELL_ENTRY(entry), 0);
+
+	return priv->check_delay;
+}
+
+/**
+ * sexy_spell_entry_set_check_delay:
+ * @entry: A #SexySpellEntry.
+ * @delay: The delay in milliseconds, 0 to check in the next frame.
+ *
+ * Sets the time to wait after a change before checking the text, see
+ * #SexySpellEntry:check-delay.
+ *
+ * Since: 1.2
+ */
+void
+sexy_spell_entry_set_check_delay(SexySpellEntry *entry, guint delay)
+{
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+
+	g_return_if_fail (SEXY_IS_SPELL_ENTRY(entry));
+
+	if (priv->check_delay == delay)
+		return;
+
+	priv->check_delay = delay;
+
+	/* Don't keep waiting for the old delay */
+	if (priv->check_timeout_id)
+	{
+		g_source_remove (priv->check_timeout_id);
+		priv->check_timeout_id = 0;
+		sexy_spell_entry_schedule_check (entry);
+	}
+
+	g_object_notify (G_OBJECT(entry), "check-delay");
+}
+
+/**
+ * sexy_spell_entry_get_prefetch_suggestions:
+ * @entry: A #SexySpellEntry.
+ *
+ * Gets whether suggestions are computed in advance, see
+ * #SexySpellEntry:prefetch-suggestions.
+ *
+ * Returns: %TRUE if suggestions are prefetched.
+ *
+ * Since: 1.2
+ */
+gboolean
+sexy_spell_entry_get_prefetch_suggestions(SexySpellEntry *entry)
+{
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+
+	g_return_val_if_fail (SEXY_IS_SPELL_ENTRY(entry), FALSE);
+
+	return priv->prefetch_suggestions;
+}
+
+/**
+ * sexy_spell_entry_set_prefetch_suggestions:
+ * @entry: A #SexySpellEntry.
+ * @prefetch: %TRUE to compute suggestions in advance.
+ *
+ * Sets whether suggestions for the misspelled word under the cursor or
+ * pointer are computed before the context menu is opened.
+ *
+ * Since: 1.2
+ */
+void
+sexy_spell_entry_set_prefetch_suggestions(SexySpellEntry *entry, gboolean prefetch)
+{
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+
+	g_return_if_fail (SEXY_IS_SPELL_ENTRY(entry));
+
+	prefetch = !!prefetch;
+	if (priv->prefetch_suggestions == prefetch)
+		return;
+
+	priv->prefetch_suggestions = prefetch;
+	if (!prefetch && priv->prefetch_timeout_id)
+	{
+		g_source_remove (priv->prefetch_timeout_id);
+		priv->prefetch_timeout_id = 0;
+	}
+
+	g_object_notify (G_OBJECT(entry), "prefetch-suggestions");
+}
+
+/**
+ * sexy_spell_entry_get_skip_rules:
+ * @entry: A #SexySpellEntry.
+ *
+ * Gets the classes of words that are not looked up.
+ *
+ * Returns: The enabled #SexySkipRules.
+ *
+ * Since: 1.2
+ */
+SexySkipRules
+sexy_spell_entry_get_skip_rules(SexySpellEntry *entry)
+{
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+
+	g_return_val_if_fail (SEXY_IS_SPELL_ENTRY(entry), SEXY_SKIP_NONE);
+
+	return sexy_spell_checker_get_skip_rules (priv->checker);
+}
+
+/**
+ * sexy_spell_entry_set_skip_rules:
+ * @entry: A #SexySpellEntry.
+ * @rules: The #SexySkipRules to enable.
+ *
+ * Sets the classes of words that are never looked up in the
+ * dictionaries and never marked as misspelled. The rules look at the
+ * whole token around a word, so the parts of a URL or path are skipped
+ * together. %SEXY_SKIP_DEFAULT is enabled by default.
+ *
+ * Since: 1.2
+ */
+void
+sexy_spell_entry_set_skip_rules(SexySpellEntry *entry, SexySkipRules rules)
+{
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+
+	g_return_if_fail (SEXY_IS_SPELL_ENTRY(entry));
+
+	sexy_spell_checker_set_skip_rules (priv->checker, rules);
+}
+
+/**
+ * sexy_spell_entry_add_skip_pattern:
+ * @entry: A #SexySpellEntry.
+ * @pattern: A Perl-compatible regular expression.
+ * @error: Return location for a #GError, or %NULL.
+ *
+ * Adds a pattern for words that are never looked up, in addition to the
+ * #SexySkipRules. The pattern has to match the whole token around a
+ * word, which is the run of non-space characters without leading and
+ * trailing punctuation. Patterns are compiled once and shared between
+ * entries.
+ *
+ * Returns: %FALSE if @pattern is invalid, and @error is set.
+ *
+ * Since: 1.2
+ */
+gboolean
+sexy_spell_entry_add_skip_pattern(SexySpellEntry *entry, const gchar *pattern, GError **error)
+{
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+
+	g_return_val_if_fail (SEXY_IS_SPELL_ENTRY(entry), FALSE);
+
+	return sexy_spell_checker_add_skip_pattern (priv->checker, pattern, error);
+}
+
+/**
+ * sexy_spell_entry_clear_skip_patterns:
+ * @entry: A #SexySpellEntry.
+ *
+ * Removes all patterns added with sexy_spell_entry_add_skip_pattern().
+ *
+ * Since: 1.2
+ */
+void
+sexy_spell_entry_clear_skip_patterns(SexySpellEntry *entry)
+{
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+
+	g_return_if_fail (SEXY_IS_SPELL_ENTRY(entry));
+
+	sexy_spell_checker_clear_skip_patterns (priv->checker);
+}
+
+/**
+ * sexy_spell_entry_get_checker:
+ * @entry: A #SexySpellEntry.
+ *
+ * Gets the checker the entry checks its text with. Changes to its
+ * languages and skip rules apply to the entry right away.
+ *
+ * Returns: (transfer none): The #SexySpellChecker.
+ *
+ * Since: 1.2
+ */
+SexySpellChecker *
+sexy_spell_entry_get_checker(SexySpellEntry *entry)
+{
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+
+	g_return_val_if_fail (SEXY_IS_SPELL_ENTRY(entry), NULL);
+
+	return priv->checker;
+}
+
+/**
+ * sexy_spell_entry_set_checker:
+ * @entry: A #SexySpellEntry.
+ * @checker: A #SexySpellChecker.
+ *
+ * Makes the entry check its text with @checker, which may be shared
+ * with other entries. Each entry starts out with a checker of its own
+ * for the default languages.
+ *
+ * Since: 1.2
+ */
+void
+sexy_spell_entry_set_checker(SexySpellEntry *entry, SexySpellChecker *checker)
+{
+	SexySpellEntryPrivate *priv = sexy_spell_entry_get_instance_private (entry);
+
+	g_return_if_fail (SEXY_IS_SPELL_ENTRY(entry));
+	g_return_if_fail (SEXY_IS_SPELL_CHECKER(checker));
+
+	if (priv->checker == checker)
+		return;
+
+	sexy_spell_entry_cancel_check (entry);
+	g_signal_handlers_disconnect_by_func (priv->checker, sexy_spell_entry_checker_changed, entry);
+	g_object_unref (priv->checker);
+
+	priv->checker = g_object_ref (checker);
+	g_signal_connect (priv->checker, "changed",
+					  G_CALLBACK(sexy_spell_entry_checker_changed), entry);
+
+	sexy_spell_entry_recheck_all (entry);
 }
@@ -23,23 +23,11 @@
 
 #include <gtk/gtk.h>
 
-#define SEXY_SPELL_ERROR (sexy_spell_error_quark())
+#include "sexy-spell-checker.h"
+
 #define SEXY_TYPE_SPELL_ENTRY (sexy_spell_entry_get_type())
 G_DECLARE_DERIVABLE_TYPE(SexySpellEntry, sexy_spell_entry, SEXY, SPELL_ENTRY, GtkEntry)
 
-/**
- * SexySpellError:
- * @SEXY_SPELL_ERROR_BACKEND: Error occured in enchant when calling
- *                            sexy_spell_entry_activate_language() or
- *                            sexy_spell_entry_set_active_languages().
- *
- * Type of error.
- */
-typedef enum {
-	SEXY_SPELL_ERROR_BACKEND
-} SexySpellError;
-
-
 struct _SexySpellEntryClass
 {
 	GtkEntryClass parent_class;
@@ -53,10 +41,37 @@ struct _SexySpellEntryClass
 	void (*_gtk_reserved3) (void);
 };
 
+/**
+ * SexySpellStats:
+ * @words_tokenized: Words split out of the text.
+ * @lookups: Words looked up in the dictionaries.
+ * @word_checks: Emissions of #SexySpellEntry::word-check.
+ * @cache_hits: Words answered from the verdict cache.
+ * @rechecks: Times the text was checked after a change.
+ * @recheck_time: Microseconds spent in those checks.
+ * @recheck_time_max: Microseconds spent in the longest one.
+ * @suggestion_calls: Words suggestions were computed for.
+ * @suggestion_time: Microseconds spent computing suggestions.
+ *
+ * Counts the spell checking work done, see sexy_spell_entry_get_stats().
+ *
+ * Since: 1.2
+ */
+typedef struct {
+	guint64 words_tokenized;
+	guint64 lookups;
+	guint64 word_checks;
+	guint64 cache_hits;
+	guint64 rechecks;
+	gint64 recheck_time;
+	gint64 recheck_time_max;
+	guint64 suggestion_calls;
+	gint64 suggestion_time;
+} SexySpellStats;
+
 G_BEGIN_DECLS
 
 GtkWidget* sexy_spell_entry_new(void);
-GQuark sexy_spell_error_quark(void);
 
 GSList* sexy_spell_entry_get_languages(const SexySpellEntry *entry);
 gchar* sexy_spell_entry_get_language_name(const SexySpellEntry *entry, const gchar *lang);
@@ -64,6 +79,12 @@ gboolean sexy_spell_entry_language_is_active(const SexySpellEntry *entry, const
 gboolean sexy_spell_entry_activate_language(SexySpellEntry *entry, const gchar *lang, GError **error);
 void sexy_spell_entry_deactivate_language(SexySpellEntry *entry, const gchar *lang);
 gboolean sexy_spell_entry_set_active_languages(SexySpellEntry *entry, GSList *langs, GError **error);
+void sexy_spell_entry_activate_language_async(SexySpellEntry *entry, const gchar *lang, GCancellable *cancellable,
+                                              GAsyncReadyCallback callback, gpointer user_data);
+gboolean sexy_spell_entry_activate_language_finish(SexySpellEntry *entry, GAsyncResult *result, GError **error);
+void sexy_spell_entry_set_active_languages_async(SexySpellEntry *entry, GSList *langs, GCancellable *cancellable,
+                                                 GAsyncReadyCallback callback, gpointer user_data);
+gboolean sexy_spell_entry_set_active_languages_finish(SexySpellEntry *entry, GAsyncResult *result, GError **error);
 GSList* sexy_spell_entry_get_active_languages(SexySpellEntry *entry);
 #ifndef G_DISABLE_DEPRECATED
 gboolean sexy_spell_entry_is_checked(SexySpellEntry *entry) G_GNUC_DEPRECATED_FOR(sexy_spell_entry_get_checked);
@@ -71,6 +92,25 @@ gboolean sexy_spell_entry_is_checked(SexySpellEntry *entry) G_GNUC_DEPRECATED_FO
 gboolean sexy_spell_entry_get_checked(SexySpellEntry *entry);
 void sexy_spell_entry_set_checked(SexySpellEntry *entry, gboolean checked);
 void sexy_spell_entry_activate_default_languages(SexySpellEntry *entry);
+guint sexy_spell_entry_get_cache_size(SexySpellEntry *entry);
+void sexy_spell_entry_set_cache_size(SexySpellEntry *entry, guint size);
+void sexy_spell_entry_get_cache_stats(SexySpellEntry *entry, guint *hits, guint *misses);
+void sexy_spell_entry_get_stats(SexySpellEntry *entry, SexySpellStats *stats);
+void sexy_spell_entry_reset_stats(SexySpellEntry *entry);
+void sexy_spell_entry_get_global_stats(SexySpellStats *stats);
+void sexy_spell_entry_reset_global_stats(void);
+gboolean sexy_spell_entry_get_async_check(SexySpellEntry *entry);
+void sexy_spell_entry_set_async_check(SexySpellEntry *entry, gboolean async_check);
+guint sexy_spell_entry_get_check_delay(SexySpellEntry *entry);
+void sexy_spell_entry_set_check_delay(SexySpellEntry *entry, guint delay);
+gboolean sexy_spell_entry_get_prefetch_suggestions(SexySpellEntry *entry);
+void sexy_spell_entry_set_prefetch_suggestions(SexySpellEntry *entry, gboolean prefetch);
+SexySkipRules sexy_spell_entry_get_skip_rules(SexySpellEntry *entry);
+void sexy_spell_entry_set_skip_rules(SexySpellEntry *entry, SexySkipRules rules);
+gboolean sexy_spell_entry_add_skip_pattern(SexySpellEntry *entry, const gchar *pattern, GError **error);
+void sexy_spell_entry_clear_skip_patterns(SexySpellEntry *entry);
+SexySpellChecker* sexy_spell_entry_get_checker(SexySpellEntry *entry);
+void sexy_spell_entry_set_checker(SexySpellEntry *entry, SexySpellChecker *checker);
 
 G_END_DECLS
 
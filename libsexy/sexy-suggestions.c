@@ -0,0 +1,234 @@
+/*
+ * @file libsexy/sexy-suggestions.c Cached spelling suggestions
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <string.h>
+
+#include "sexy-suggestions.h"
+#include "sexy-dict-registry.h"
+
+/*
+ * Suggesting can take a good fraction of a second, so suggestions are
+ * computed on a thread of their own and remembered per backend, language
+ * and word until a word list changes. Everything except
+ * suggestions_run() happens in the main thread.
+ */
+
+#define MAX_CACHED 128
+
+typedef struct
+{
+	gchar *key;
+	SexySpellBackend *backend;
+	gchar *lang;
+	gchar *word;
+	gchar **suggestions;
+	gint64 elapsed;
+	guint generation;
+} SuggestionsJob;
+
+typedef struct
+{
+	SexySuggestionsFunc callback;
+	gpointer user_data;
+	gboolean started;
+} SuggestionsWaiter;
+
+static GHashTable *cache = NULL;
+static GHashTable *pending = NULL;
+static GThreadPool *pool = NULL;
+static guint cache_generation = 0;
+
+static gchar *
+make_key (SexyDict *dict, const gchar *word)
+{
+	gchar *lang, *key;
+
+	lang = sexy_dict_registry_get_lang (dict);
+	key = g_strdup_printf ("%p\n%s\n%s", (gpointer) sexy_dict_registry_get_backend (dict), lang, word);
+	g_free (lang);
+
+	return key;
+}
+
+/**
+ * sexy_suggestions_lookup:
+ * @dict: The dictionary to suggest from.
+ * @word: The misspelled word.
+ *
+ * Returns: (transfer none) (nullable): The cached suggestions, or %NULL
+ *          if they still have to be fetched.
+ */
+const gchar * const *
+sexy_suggestions_lookup (SexyDict *dict, const gchar *word)
+{
+	const gchar * const *suggestions;
+	gchar *key;
+
+	if (cache == NULL)
+		return NULL;
+
+	if (cache_generation != sexy_dict_registry_get_suggestion_generation ())
+	{
+		g_hash_table_remove_all (cache);
+		cache_generation = sexy_dict_registry_get_suggestion_generation ();
+	}
+
+	key = make_key (dict, word);
+	suggestions = g_hash_table_lookup (cache, key);
+	g_free (key);
+
+	return suggestions;
+}
+
+static void
+suggestions_job_free (SuggestionsJob *job)
+{
+	g_free (job->key);
+	g_object_unref (job->backend);
+	g_free (job->lang);
+	g_free (job->word);
+	g_strfreev (job->suggestions);
+	g_free (job);
+}
+
+static gboolean
+suggestions_done (gpointer data)
+{
+	SuggestionsJob *job = data;
+	const gchar * const *suggestions = (const gchar * const *) job->suggestions;
+	GSList *waiters, *li;
+
+	/* Don't remember what was suggested before a word was added or a
+	 * replacement stored */
+	if (job->generation == sexy_dict_registry_get_suggestion_generation ())
+	{
+		if (cache_generation != job->generation)
+		{
+			g_hash_table_remove_all (cache);
+			cache_generation = job->generation;
+		}
+		if (g_hash_table_size (cache) >= MAX_CACHED)
+			g_hash_table_remove_all (cache);
+
+		g_hash_table_insert (cache, g_strdup (job->key), job->suggestions);
+		job->suggestions = NULL;
+	}
+
+	waiters = g_hash_table_lookup (pending, job->key);
+	g_hash_table_remove (pending, job->key);
+	waiters = g_slist_reverse (waiters);
+	for (li = waiters; li; li = g_slist_next (li))
+	{
+		SuggestionsWaiter *waiter = li->data;
+
+		waiter->callback (suggestions, waiter->started ? job->elapsed : -1, waiter->user_data);
+		g_free (waiter);
+	}
+	g_slist_free (waiters);
+
+	suggestions_job_free (job);
+	return G_SOURCE_REMOVE;
+}
+
+static void
+suggestions_run (gpointer data, gpointer pool_data)
+{
+	SuggestionsJob *job = data;
+	SexyDict *dict;
+	gint64 start = g_get_monotonic_time ();
+
+	dict = sexy_dict_registry_get_thread_dict (job->backend, job->lang);
+	if (dict != NULL)
+		job->suggestions = sexy_dict_suggest (dict, job->word);
+	if (job->suggestions == NULL)
+		job->suggestions = g_new0 (gchar *, 1);
+	job->elapsed = g_get_monotonic_time () - start;
+
+	g_idle_add (suggestions_done, job);
+}
+
+/**
+ * sexy_suggestions_fetch:
+ * @dict: The dictionary to suggest from.
+ * @word: The misspelled word.
+ * @callback: (nullable): Called in the main thread with the suggestions,
+ *            which are only valid during the call.
+ * @user_data: Data for @callback.
+ *
+ * Computes the suggestions for @word in the background. Without a
+ * @callback this only fills the cache for a later lookup.
+ *
+ * @callback also gets the microseconds spent suggesting, or -1 if the
+ * word was already being looked up for someone else, so the time is
+ * only accounted for once.
+ */
+void
+sexy_suggestions_fetch (SexyDict *dict, const gchar *word,
+                        SexySuggestionsFunc callback, gpointer user_data)
+{
+	SuggestionsJob *job;
+	GSList *waiters;
+	gchar *key;
+	gboolean running;
+
+	if (cache == NULL)
+	{
+		cache = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_strfreev);
+		pending = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+		pool = g_thread_pool_new (suggestions_run, NULL, 1, FALSE, NULL);
+	}
+
+	key = make_key (dict, word);
+	running = g_hash_table_lookup_extended (pending, key, NULL, (gpointer *) &waiters);
+
+	if (callback != NULL)
+	{
+		SuggestionsWaiter *waiter = g_new0 (SuggestionsWaiter, 1);
+
+		waiter->callback = callback;
+		waiter->user_data = user_data;
+		waiter->started = !running;
+		waiters = g_slist_prepend (running ? waiters : NULL, waiter);
+	}
+	else if (!running)
+	{
+		waiters = NULL;
+	}
+
+	/* The same word is looked up only once at a time */
+	g_hash_table_insert (pending, g_strdup (key), waiters);
+	if (running)
+	{
+		g_free (key);
+		return;
+	}
+
+	job = g_new0 (SuggestionsJob, 1);
+	job->key = key;
+	job->backend = g_object_ref (sexy_dict_registry_get_backend (dict));
+	job->lang = sexy_dict_registry_get_lang (dict);
+	job->word = g_strdup (word);
+	job->generation = sexy_dict_registry_get_suggestion_generation ();
+
+	g_thread_pool_push (pool, job, NULL);
+}
@@ -0,0 +1,34 @@
+/*
+ * @file libsexy/sexy-suggestions.h Cached spelling suggestions
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+#pragma once
+
+#include <glib.h>
+
+#include "sexy-dict-registry.h"
+
+G_BEGIN_DECLS
+
+typedef void (*SexySuggestionsFunc) (const gchar * const *suggestions, gint64 elapsed, gpointer user_data);
+
+const gchar * const *sexy_suggestions_lookup (SexyDict *dict, const gchar *word);
+void sexy_suggestions_fetch (SexyDict *dict, const gchar *word,
+                             SexySuggestionsFunc callback, gpointer user_data);
+
+G_END_DECLS
@@ -0,0 +1,343 @@
+/*
+ * @file libsexy/sexy-tokenizer.c Splitting text into words
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <string.h>
+
+#include <pango/pango.h>
+
+#if defined(__AVX2__)
+# include <immintrin.h>
+#elif defined(__SSE2__)
+# include <emmintrin.h>
+#endif
+
+#include "sexy-tokenizer.h"
+
+/*
+ * Word boundaries for ASCII text are found directly from the bytes, 32
+ * at a time, following the Unicode word break rules as far as they
+ * apply to ASCII. Only the runs of non-space characters that contain
+ * non-ASCII characters are handed to Pango. Words never span ASCII
+ * white space, so the two never disagree about where a run starts.
+ */
+
+#define BLOCK 32
+#define MAX_STACK_ATTRS 128
+
+#define IS_LETTER(c) (g_ascii_isalpha (c))
+#define IS_DIGIT(c) (g_ascii_isdigit (c))
+#define IS_WORD_CHAR(c) (g_ascii_isalnum (c) || (c) == '_')
+
+#if defined(__GNUC__)
+# define FIRST_BIT(mask) __builtin_ctz (mask)
+#else
+# define FIRST_BIT(mask) g_bit_nth_lsf (mask, -1)
+#endif
+
+#if defined(__AVX2__)
+
+static inline guint32
+block_word_mask (const guchar *p)
+{
+	__m256i v = _mm256_loadu_si256 ((const __m256i *) p);
+	__m256i lower = _mm256_or_si256 (v, _mm256_set1_epi8 (0x20));
+	__m256i alpha, digit, under;
+
+	/* Unsigned range checks as signed compares against -128 + size */
+	alpha = _mm256_cmpgt_epi8 (_mm256_set1_epi8 (-128 + 26),
+	                           _mm256_add_epi8 (lower, _mm256_set1_epi8 ((gchar) (0x80 - 'a'))));
+	digit = _mm256_cmpgt_epi8 (_mm256_set1_epi8 (-128 + 10),
+	                           _mm256_add_epi8 (v, _mm256_set1_epi8 ((gchar) (0x80 - '0'))));
+	under = _mm256_cmpeq_epi8 (v, _mm256_set1_epi8 ('_'));
+
+	return (guint32) _mm256_movemask_epi8 (_mm256_or_si256 (_mm256_or_si256 (alpha, digit), under));
+}
+
+static inline guint32
+block_high_mask (const guchar *p)
+{
+	return (guint32) _mm256_movemask_epi8 (_mm256_loadu_si256 ((const __m256i *) p));
+}
+
+#elif defined(__SSE2__)
+
+static inline guint32
+half_word_mask (const guchar *p)
+{
+	__m128i v = _mm_loadu_si128 ((const __m128i *) p);
+	__m128i lower = _mm_or_si128 (v, _mm_set1_epi8 (0x20));
+	__m128i alpha, digit, under;
+
+	/* Unsigned range checks as signed compares against -128 + size */
+	alpha = _mm_cmplt_epi8 (_mm_add_epi8 (lower, _mm_set1_epi8 ((gchar) (0x80 - 'a'))),
+	                        _mm_set1_epi8 (-128 + 26));
+	digit = _mm_cmplt_epi8 (_mm_add_epi8 (v, _mm_set1_epi8 ((gchar) (0x80 - '0'))),
+	                        _mm_set1_epi8 (-128 + 10));
+	under = _mm_cmpeq_epi8 (v, _mm_set1_epi8 ('_'));
+
+	return (guint32) _mm_movemask_epi8 (_mm_or_si128 (_mm_or_si128 (alpha, digit), under));
+}
+
+static inline guint32
+block_word_mask (const guchar *p)
+{
+	return half_word_mask (p) | half_word_mask (p + 16) << 16;
+}
+
+static inline guint32
+block_high_mask (const guchar *p)
+{
+	return (guint32) _mm_movemask_epi8 (_mm_loadu_si128 ((const __m128i *) p)) |
+	       (guint32) _mm_movemask_epi8 (_mm_loadu_si128 ((const __m128i *) (p + 16))) << 16;
+}
+
+#else
+
+static inline guint32
+block_word_mask (const guchar *p)
+{
+	guint32 mask = 0;
+	guint i;
+
+	for (i = 0; i < BLOCK; i++)
+		mask |= (guint32) IS_WORD_CHAR (p[i]) << i;
+	return mask;
+}
+
+static inline guint32
+block_high_mask (const guchar *p)
+{
+	guint32 mask = 0;
+	guint i;
+
+	for (i = 0; i < BLOCK; i++)
+		mask |= (guint32) (p[i] >> 7) << i;
+	return mask;
+}
+
+#endif
+
+/* Bits for the bytes in [pos, limit), at most BLOCK of them */
+static inline guint32
+word_mask (const gchar *text, gint pos, gint limit)
+{
+	const guchar *p = (const guchar *) text + pos;
+	guint32 mask = 0;
+	gint i;
+
+	if (limit - pos >= BLOCK)
+		return block_word_mask (p);
+
+	for (i = 0; i < limit - pos; i++)
+		mask |= (guint32) IS_WORD_CHAR (p[i]) << i;
+	return mask;
+}
+
+/* Finds the first position from @pos that is (or is not) a word char */
+static gint
+scan (const gchar *text, gint pos, gint limit, gboolean word_char)
+{
+	while (pos < limit)
+	{
+		guint32 mask = word_mask (text, pos, limit);
+
+		if (!word_char)
+			mask = ~mask;
+		if (limit - pos < BLOCK)
+			mask &= (1u << (limit - pos)) - 1;
+
+		if (mask != 0)
+			return pos + FIRST_BIT (mask);
+		pos += BLOCK;
+	}
+	return limit;
+}
+
+static gint
+find_non_ascii (const gchar *text, gint pos, gint limit)
+{
+	const guchar *p = (const guchar *) text;
+
+	for (; limit - pos >= BLOCK; pos += BLOCK)
+	{
+		guint32 mask = block_high_mask (p + pos);
+
+		if (mask != 0)
+			return pos + FIRST_BIT (mask);
+	}
+	for (; pos < limit; pos++)
+	{
+		if (p[pos] & 0x80)
+			return pos;
+	}
+	return limit;
+}
+
+static gint
+find_space (const gchar *text, gint pos, gint limit)
+{
+	while (pos < limit && !g_ascii_isspace (text[pos]))
+		pos++;
+	return pos;
+}
+
+/* Whether the punctuation at @pos keeps the word going, as in don't,
+ * e.g and 3.14. These are MidLetter, MidNumLet and MidNum of UAX #29,
+ * so ; only joins digits, like Pango does. */
+static gboolean
+joins (const gchar *text, gint pos, gint limit)
+{
+	gchar prev, c, next;
+
+	if (pos + 1 >= limit)
+		return FALSE;
+
+	prev = text[pos - 1];
+	c = text[pos];
+	next = text[pos + 1];
+
+	if (IS_LETTER (prev) && IS_LETTER (next))
+		return c == '\'' || c == '.' || c == ':';
+	if (IS_DIGIT (prev) && IS_DIGIT (next))
+		return c == '\'' || c == '.' || c == ',' || c == ';';
+	return FALSE;
+}
+
+static void
+tokenize_ascii (const gchar *text, gint pos, gint limit, gint end, SexyWordList *words)
+{
+	while (pos < limit)
+	{
+		gint word_start, word_end;
+
+		word_start = scan (text, pos, limit, TRUE);
+		if (word_start >= limit || word_start >= end)
+			break;
+
+		word_end = scan (text, word_start, limit, FALSE);
+		while (joins (text, word_end, limit))
+			word_end = scan (text, word_end + 1, limit, FALSE);
+
+		sexy_word_list_append (words, word_start, word_end);
+		pos = word_end;
+	}
+}
+
+static void
+tokenize_pango (const gchar *text, gint from, gint to, gint end, SexyWordList *words)
+{
+	PangoLogAttr stack_attrs[MAX_STACK_ATTRS], *attrs;
+	const gchar *p;
+	glong n_chars;
+	gint word_start = -1;
+	glong i;
+
+	if (from >= to)
+		return;
+
+	n_chars = g_utf8_strlen (text + from, to - from);
+	attrs = n_chars < MAX_STACK_ATTRS ? stack_attrs : g_new (PangoLogAttr, n_chars + 1);
+	pango_get_log_attrs (text + from, to - from, -1, pango_language_get_default (),
+	                     attrs, n_chars + 1);
+
+	/* There is one log attr per character plus one for the end */
+	p = text + from;
+	for (i = 0; i <= n_chars; i++)
+	{
+		const PangoLogAttr *a = &attrs[i];
+
+		if (word_start >= 0 && a->is_word_end && a->is_word_boundary)
+		{
+			sexy_word_list_append (words, word_start, (gint) (p - text));
+			word_start = -1;
+		}
+
+		if (word_start < 0 && a->is_word_start && a->is_word_boundary)
+		{
+			if (p - text >= end)
+				break;
+			word_start = (gint) (p - text);
+		}
+
+		if (i < n_chars)
+			p = g_utf8_next_char (p);
+	}
+
+	if (attrs != stack_attrs)
+		g_free (attrs);
+}
+
+/**
+ * sexy_tokenize:
+ * @text: The text.
+ * @text_len: The length of @text in bytes.
+ * @start: Where to start, in bytes.
+ * @end: Words starting at or after this byte offset are left out.
+ * @words: The list to append to.
+ *
+ * Appends the words starting in [@start, @end) of @text to @words.
+ * Words starting before @end are appended whole.
+ */
+void
+sexy_tokenize (const gchar *text, gint text_len, gint start, gint end, SexyWordList *words)
+{
+	gint limit = find_space (text, MIN(end, text_len), text_len);
+	gint pos = start;
+
+	while (pos < limit)
+	{
+		gint non_ascii, from, to;
+
+		non_ascii = find_non_ascii (text, pos, limit);
+		if (non_ascii >= limit)
+		{
+			tokenize_ascii (text, pos, limit, end, words);
+			break;
+		}
+
+		/* Leave the run of non-space characters around it to Pango */
+		for (from = non_ascii; from > pos && !g_ascii_isspace (text[from - 1]); from--)
+			;
+		to = find_space (text, non_ascii, limit);
+
+		tokenize_ascii (text, pos, from, end, words);
+		tokenize_pango (text, from, to, end, words);
+		pos = to;
+	}
+}
+
+/**
+ * sexy_tokenize_pango:
+ * @text: The text.
+ * @text_len: The length of @text in bytes.
+ * @start: Where to start, in bytes.
+ * @end: Words starting at or after this byte offset are left out.
+ * @words: The list to append to.
+ *
+ * Like sexy_tokenize(), but leaves all of the text to Pango.
+ */
+void
+sexy_tokenize_pango (const gchar *text, gint text_len, gint start, gint end, SexyWordList *words)
+{
+	tokenize_pango (text, start, find_space (text, MIN(end, text_len), text_len), end, words);
+}
@@ -0,0 +1,69 @@
+/*
+ * @file libsexy/sexy-trace.h Tracing marks
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+#pragma once
+
+#include <glib.h>
+
+/*
+ * Marks the work that can show up as typing lag, so it can be lined up
+ * with GTK's frame marks:
+ *
+ *   SEXY_TRACE_BEGIN (recheck_all, entry, length);
+ *   ...
+ *   SEXY_TRACE_END (recheck_all, entry, length);
+ *
+ * The object is the entry, or whatever else the work is done for, and
+ * the length is that of the text, in bytes or words.
+ *
+ * With --enable-tracing=sysprof every pair becomes a mark in the
+ * "libsexy3" group. With --enable-tracing=usdt it becomes the probes
+ * libsexy3:NAME__begin and libsexy3:NAME__end, taking the object and
+ * length as arguments. Otherwise nothing is compiled in, not even the
+ * arguments.
+ *
+ * A pair must be in the same block, and every name only used once in it.
+ */
+
+#if defined(HAVE_SYSPROF)
+
+#include <sysprof-capture.h>
+
+#define SEXY_TRACE_BEGIN(name, object, length) \
+	gint64 sexy_trace_##name = SYSPROF_CAPTURE_CURRENT_TIME
+#define SEXY_TRACE_END(name, object, length) \
+	sysprof_collector_mark_printf (sexy_trace_##name, SYSPROF_CAPTURE_CURRENT_TIME - sexy_trace_##name, \
+	                               "libsexy3", #name, "object=%p length=%" G_GINT64_FORMAT, \
+	                               (gpointer) (object), (gint64) (length))
+
+#elif defined(HAVE_USDT)
+
+#include <sys/sdt.h>
+
+#define SEXY_TRACE_BEGIN(name, object, length) \
+	DTRACE_PROBE2 (libsexy3, name##__begin, (gpointer) (object), (gint64) (length))
+#define SEXY_TRACE_END(name, object, length) \
+	DTRACE_PROBE2 (libsexy3, name##__end, (gpointer) (object), (gint64) (length))
+
+#else
+
+#define SEXY_TRACE_BEGIN(name, object, length) G_STMT_START { } G_STMT_END
+#define SEXY_TRACE_END(name, object, length) G_STMT_START { } G_STMT_END
+
+#endif
@@ -0,0 +1,191 @@
+/*
+ * @file libsexy/sexy-word-list.c Word spans of a text
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <string.h>
+
+#include "sexy-word-list.h"
+
+#define MIN_CAPACITY 64
+
+SexyWordList *
+sexy_word_list_new (void)
+{
+	return g_new0 (SexyWordList, 1);
+}
+
+void
+sexy_word_list_free (SexyWordList *list)
+{
+	g_free (list->starts);
+	g_free (list);
+}
+
+/**
+ * sexy_word_list_clear:
+ * @list: A #SexyWordList.
+ *
+ * Removes all words, keeping the memory for the next ones.
+ */
+void
+sexy_word_list_clear (SexyWordList *list)
+{
+	list->len = 0;
+}
+
+/* The columns are laid out one after the other in the block pointed to
+ * by starts: capacity starts, capacity ends, capacity verdicts. */
+static void
+reserve (SexyWordList *list, guint n_words)
+{
+	guint capacity = MAX(list->capacity, MIN_CAPACITY);
+	gchar *arena;
+	gint *starts, *ends;
+	guint8 *verdicts;
+
+	if (n_words <= list->capacity)
+		return;
+
+	while (capacity < n_words)
+		capacity *= 2;
+
+	arena = g_malloc (capacity * (2 * sizeof (gint) + sizeof (guint8)));
+	starts = (gint *) arena;
+	ends = starts + capacity;
+	verdicts = (guint8 *) (ends + capacity);
+
+	if (list->len)
+	{
+		memcpy (starts, list->starts, list->len * sizeof (gint));
+		memcpy (ends, list->ends, list->len * sizeof (gint));
+		memcpy (verdicts, list->verdicts, list->len);
+	}
+	g_free (list->starts);
+
+	list->starts = starts;
+	list->ends = ends;
+	list->verdicts = verdicts;
+	list->capacity = capacity;
+}
+
+void
+sexy_word_list_append (SexyWordList *list, gint start, gint end)
+{
+	reserve (list, list->len + 1);
+
+	list->starts[list->len] = start;
+	list->ends[list->len] = end;
+	list->verdicts[list->len] = SEXY_WORD_UNCHECKED;
+	list->len++;
+}
+
+/**
+ * sexy_word_list_insert:
+ * @list: A #SexyWordList.
+ * @index: Where to insert.
+ * @words: The words to insert, which must sort between the neighbours.
+ *
+ * Copies all of @words into @list, before the word at @index.
+ */
+void
+sexy_word_list_insert (SexyWordList *list, guint index, const SexyWordList *words)
+{
+	guint n_after;
+
+	g_return_if_fail (index <= list->len);
+
+	if (words->len == 0)
+		return;
+
+	reserve (list, list->len + words->len);
+
+	n_after = list->len - index;
+	memmove (list->starts + index + words->len, list->starts + index, n_after * sizeof (gint));
+	memmove (list->ends + index + words->len, list->ends + index, n_after * sizeof (gint));
+	memmove (list->verdicts + index + words->len, list->verdicts + index, n_after);
+
+	memcpy (list->starts + index, words->starts, words->len * sizeof (gint));
+	memcpy (list->ends + index, words->ends, words->len * sizeof (gint));
+	memcpy (list->verdicts + index, words->verdicts, words->len);
+
+	list->len += words->len;
+}
+
+void
+sexy_word_list_remove_range (SexyWordList *list, guint index, guint n_words)
+{
+	guint n_after;
+
+	g_return_if_fail (index + n_words <= list->len);
+
+	n_after = list->len - index - n_words;
+	memmove (list->starts + index, list->starts + index + n_words, n_after * sizeof (gint));
+	memmove (list->ends + index, list->ends + index + n_words, n_after * sizeof (gint));
+	memmove (list->verdicts + index, list->verdicts + index + n_words, n_after);
+
+	list->len -= n_words;
+}
+
+/**
+ * sexy_word_list_bisect:
+ * @column: The starts or the ends of a #SexyWordList.
+ * @len: The number of words.
+ * @pos: A byte offset.
+ *
+ * Returns: The index of the first word whose offset in @column is at
+ *          least @pos, or @len.
+ */
+guint
+sexy_word_list_bisect (const gint *column, guint len, gint pos)
+{
+	guint lo = 0, hi = len;
+
+	while (lo < hi)
+	{
+		guint mid = lo + (hi - lo) / 2;
+
+		if (column[mid] < pos)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo;
+}
+
+/**
+ * sexy_word_list_find:
+ * @list: A #SexyWordList.
+ * @pos: A byte offset.
+ *
+ * Returns: The index of the word containing @pos, or ending right at it,
+ *          or -1.
+ */
+gint
+sexy_word_list_find (const SexyWordList *list, gint pos)
+{
+	guint index = sexy_word_list_bisect (list->ends, list->len, pos);
+
+	if (index < list->len && list->starts[index] <= pos)
+		return (gint) index;
+	return -1;
+}
@@ -0,0 +1,54 @@
+/*
+ * @file libsexy/sexy-word-list.h Word spans of a text
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef enum
+{
+	SEXY_WORD_UNCHECKED,
+	SEXY_WORD_CORRECT,
+	SEXY_WORD_MISSPELLED,
+	SEXY_WORD_PENDING
+} SexyWordVerdict;
+
+/* Columns of @len words, sorted by start byte offset. They all live in
+ * one block that only grows, so refilling the list allocates nothing. */
+typedef struct
+{
+	guint len;
+	guint capacity;
+	gint *starts;
+	gint *ends;
+	guint8 *verdicts;
+} SexyWordList;
+
+SexyWordList *sexy_word_list_new (void);
+void sexy_word_list_free (SexyWordList *list);
+void sexy_word_list_clear (SexyWordList *list);
+void sexy_word_list_append (SexyWordList *list, gint start, gint end);
+void sexy_word_list_insert (SexyWordList *list, guint index, const SexyWordList *words);
+void sexy_word_list_remove_range (SexyWordList *list, guint index, guint n_words);
+guint sexy_word_list_bisect (const gint *column, guint len, gint pos);
+gint sexy_word_list_find (const SexyWordList *list, gint pos);
+
+G_END_DECLS
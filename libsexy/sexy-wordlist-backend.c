@@ -0,0 +1,755 @@
+/*
+ * @file libsexy/sexy-wordlist-backend.c Dictionaries from word lists
+ *
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <string.h>
+
+#include <glib/gi18n.h>
+
+#include "sexy-wordlist-backend.h"
+
+/**
+ * SECTION: sexy-wordlist-backend
+ * @short_description: Dictionaries from plain word lists
+ * @title: WordlistBackend
+ * @see_also: #SexySpellBackend
+ * @include: libsexy3/sexy-wordlist-backend.h
+ *
+ * A #SexySpellBackend that checks words against lists held in memory,
+ * so results do not depend on the dictionaries installed. A word is
+ * spelled correctly if it is in the list, or if it is capitalized or in
+ * capitals and its lower case form is. Suggestions are the listed words
+ * closest to a misspelled one.
+ *
+ * Lookups, suggestions and loading can be slowed down on purpose to
+ * model slow providers, see #SexyWordlistBackend:check-latency.
+ *
+ * Words added to the personal word list are only kept for as long as
+ * the dictionary is loaded.
+ */
+
+#define MAX_SUGGESTIONS 10
+#define MAX_DISTANCE 2
+#define MAX_WORD_LENGTH 256
+
+/* The words of a language. Never changed once a dictionary uses it, a
+ * new set replaces it instead. */
+typedef struct
+{
+	gint ref_count;
+	GHashTable *words;
+} WordSet;
+
+typedef struct
+{
+	WordSet *set;
+	gchar *lang;
+	GHashTable *session;
+	GHashTable *replacements;
+} Dict;
+
+struct _SexyWordlistBackend
+{
+	GObject parent_instance;
+
+	GMutex lock;
+	GHashTable *langs;
+
+	/* In microseconds, read from any thread */
+	gint check_latency;
+	gint suggest_latency;
+	gint load_latency;
+};
+
+enum
+{
+	PROP_0,
+	PROP_CHECK_LATENCY,
+	PROP_SUGGEST_LATENCY,
+	PROP_LOAD_LATENCY,
+	N_PROPERTIES
+};
+
+static void sexy_wordlist_backend_iface_init (SexySpellBackendInterface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (SexyWordlistBackend, sexy_wordlist_backend, G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (SEXY_TYPE_SPELL_BACKEND, sexy_wordlist_backend_iface_init))
+
+static WordSet *
+word_set_new (void)
+{
+	WordSet *set = g_new0 (WordSet, 1);
+
+	set->ref_count = 1;
+	set->words = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+	return set;
+}
+
+static WordSet *
+word_set_ref (WordSet *set)
+{
+	g_atomic_int_inc (&set->ref_count);
+	return set;
+}
+
+static void
+word_set_unref (WordSet *set)
+{
+	if (!g_atomic_int_dec_and_test (&set->ref_count))
+		return;
+
+	g_hash_table_destroy (set->words);
+	g_free (set);
+}
+
+/* Gets the set of @lang that words can be added to, copying it if a
+ * dictionary uses it. Called with the lock held. */
+static WordSet *
+get_writable_set (SexyWordlistBackend *backend, const gchar *lang)
+{
+	WordSet *set = g_hash_table_lookup (backend->langs, lang);
+	WordSet *copy;
+	GHashTableIter iter;
+	gpointer word;
+
+	if (set != NULL && g_atomic_int_get (&set->ref_count) == 1)
+		return set;
+
+	copy = word_set_new ();
+	if (set != NULL)
+	{
+		g_hash_table_iter_init (&iter, set->words);
+		while (g_hash_table_iter_next (&iter, &word, NULL))
+			g_hash_table_add (copy->words, g_strdup (word));
+	}
+
+	g_hash_table_insert (backend->langs, g_strdup (lang), copy);
+	return copy;
+}
+
+/* Busy waits, so the latency shows up as CPU time like a real lookup */
+static void
+spin (gint usec)
+{
+	gint64 end;
+
+	if (usec <= 0)
+		return;
+
+	end = g_get_monotonic_time () + usec;
+	while (g_get_monotonic_time () < end)
+		;
+}
+
+static gint
+compare_langs (gconstpointer a, gconstpointer b)
+{
+	return strcmp (*(const gchar * const *) a, *(const gchar * const *) b);
+}
+
+static gchar **
+sexy_wordlist_backend_list_languages (SexySpellBackend *spell_backend)
+{
+	SexyWordlistBackend *backend = SEXY_WORDLIST_BACKEND(spell_backend);
+	GHashTableIter iter;
+	GPtrArray *langs;
+	gpointer lang;
+
+	langs = g_ptr_array_new ();
+
+	g_mutex_lock (&backend->lock);
+	g_hash_table_iter_init (&iter, backend->langs);
+	while (g_hash_table_iter_next (&iter, &lang, NULL))
+		g_ptr_array_add (langs, g_strdup (lang));
+	g_mutex_unlock (&backend->lock);
+
+	g_ptr_array_sort (langs, compare_langs);
+	g_ptr_array_add (langs, NULL);
+
+	return (gchar **) g_ptr_array_free (langs, FALSE);
+}
+
+static gpointer
+sexy_wordlist_backend_request_dict (SexySpellBackend *spell_backend, const gchar *lang)
+{
+	SexyWordlistBackend *backend = SEXY_WORDLIST_BACKEND(spell_backend);
+	WordSet *set;
+	Dict *dict;
+
+	g_usleep (g_atomic_int_get (&backend->load_latency));
+
+	g_mutex_lock (&backend->lock);
+	set = g_hash_table_lookup (backend->langs, lang);
+	if (set != NULL)
+		word_set_ref (set);
+	g_mutex_unlock (&backend->lock);
+
+	if (set == NULL)
+		return NULL;
+
+	dict = g_new0 (Dict, 1);
+	dict->set = set;
+	dict->lang = g_strdup (lang);
+	dict->session = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	dict->replacements = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+
+	return dict;
+}
+
+static void
+sexy_wordlist_backend_free_dict (SexySpellBackend *spell_backend, gpointer data)
+{
+	Dict *dict = data;
+
+	word_set_unref (dict->set);
+	g_hash_table_destroy (dict->session);
+	g_hash_table_destroy (dict->replacements);
+	g_free (dict->lang);
+	g_free (dict);
+}
+
+static const gchar *
+sexy_wordlist_backend_describe_dict (SexySpellBackend *spell_backend, gpointer data)
+{
+	Dict *dict = data;
+
+	return dict->lang;
+}
+
+static gboolean
+dict_contains (Dict *dict, const gchar *word)
+{
+	return g_hash_table_contains (dict->set->words, word) || g_hash_table_contains (dict->session, word);
+}
+
+static gboolean
+sexy_wordlist_backend_check (SexySpellBackend *spell_backend, gpointer data, const gchar *word, gssize length)
+{
+	SexyWordlistBackend *backend = SEXY_WORDLIST_BACKEND(spell_backend);
+	Dict *dict = data;
+	gchar *copy = NULL, *lower, *upper;
+	gboolean found;
+
+	spin (g_atomic_int_get (&backend->check_latency));
+
+	if (length >= 0)
+		word = copy = g_strndup (word, length);
+
+	found = dict_contains (dict, word);
+	if (!found)
+	{
+		/* "Word" and "WORD" are right if "word" is */
+		lower = g_utf8_strdown (word, -1);
+		upper = g_utf8_strup (word, -1);
+		if (*word != '\0' && strcmp (lower, word) != 0 &&
+		    (strcmp (upper, word) == 0 || strcmp (g_utf8_next_char (lower), g_utf8_next_char (word)) == 0))
+			found = dict_contains (dict, lower);
+		g_free (upper);
+		g_free (lower);
+	}
+
+	g_free (copy);
+	return found;
+}
+
+/* Edit distance between two byte strings, or MAX_DISTANCE + 1 if it is
+ * larger than that */
+static guint
+distance (const gchar *a, gsize a_len, const gchar *b, gsize b_len)
+{
+	guint rows[2][MAX_WORD_LENGTH + 1];
+	guint *prev = rows[0], *cur = rows[1], *tmp;
+	gsize i, j;
+
+	if ((a_len > b_len ? a_len - b_len : b_len - a_len) > MAX_DISTANCE)
+		return MAX_DISTANCE + 1;
+
+	for (j = 0; j <= b_len; j++)
+		prev[j] = j;
+
+	for (i = 1; i <= a_len; i++)
+	{
+		guint row_min;
+
+		cur[0] = row_min = i;
+		for (j = 1; j <= b_len; j++)
+		{
+			guint cost = prev[j - 1] + (a[i - 1] != b[j - 1]);
+
+			cost = MIN(cost, prev[j] + 1);
+			cost = MIN(cost, cur[j - 1] + 1);
+			cur[j] = cost;
+			row_min = MIN(row_min, cost);
+		}
+
+		if (row_min > MAX_DISTANCE)
+			return MAX_DISTANCE + 1;
+
+		tmp = prev;
+		prev = cur;
+		cur = tmp;
+	}
+
+	return MIN(prev[b_len], MAX_DISTANCE + 1);
+}
+
+typedef struct
+{
+	const gchar *word;
+	guint distance;
+} Candidate;
+
+static gint
+compare_candidates (gconstpointer a, gconstpointer b)
+{
+	const Candidate *ca = a, *cb = b;
+
+	if (ca->distance != cb->distance)
+		return ca->distance < cb->distance ? -1 : 1;
+	return strcmp (ca->word, cb->word);
+}
+
+static gchar **
+sexy_wordlist_backend_suggest (SexySpellBackend *spell_backend, gpointer data, const gchar *word, gssize length)
+{
+	SexyWordlistBackend *backend = SEXY_WORDLIST_BACKEND(spell_backend);
+	Dict *dict = data;
+	GArray *candidates;
+	GPtrArray *suggestions;
+	const gchar *replacement;
+	GHashTableIter iter;
+	gpointer key;
+	gchar *lower;
+	gsize lower_len;
+	guint i;
+
+	spin (g_atomic_int_get (&backend->suggest_latency));
+
+	lower = g_utf8_strdown (word, length);
+	lower_len = strlen (lower);
+	suggestions = g_ptr_array_new ();
+
+	replacement = g_hash_table_lookup (dict->replacements, lower);
+	if (replacement != NULL)
+		g_ptr_array_add (suggestions, g_strdup (replacement));
+
+	candidates = g_array_new (FALSE, FALSE, sizeof (Candidate));
+	if (lower_len <= MAX_WORD_LENGTH)
+	{
+		g_hash_table_iter_init (&iter, dict->set->words);
+		while (g_hash_table_iter_next (&iter, &key, NULL))
+		{
+			Candidate candidate = { key, 0 };
+			gsize len = strlen (key);
+
+			if (len > MAX_WORD_LENGTH)
+				continue;
+
+			candidate.distance = distance (lower, lower_len, key, len);
+			if (candidate.distance <= MAX_DISTANCE && candidate.distance > 0)
+				g_array_append_val (candidates, candidate);
+		}
+	}
+	g_array_sort (candidates, compare_candidates);
+
+	for (i = 0; i < candidates->len && suggestions->len < MAX_SUGGESTIONS; i++)
+	{
+		const gchar *candidate = g_array_index (candidates, Candidate, i).word;
+
+		if (g_strcmp0 (candidate, replacement) != 0)
+			g_ptr_array_add (suggestions, g_strdup (candidate));
+	}
+	g_ptr_array_add (suggestions, NULL);
+
+	g_array_unref (candidates);
+	g_free (lower);
+
+	return (gchar **) g_ptr_array_free (suggestions, FALSE);
+}
+
+static void
+sexy_wordlist_backend_add_to_session (SexySpellBackend *spell_backend, gpointer data, const gchar *word)
+{
+	Dict *dict = data;
+
+	g_hash_table_add (dict->session, g_strdup (word));
+}
+
+static void
+sexy_wordlist_backend_store_replacement (SexySpellBackend *spell_backend, gpointer data,
+                                         const gchar *misspelled, const gchar *correction)
+{
+	Dict *dict = data;
+
+	g_hash_table_insert (dict->replacements, g_utf8_strdown (misspelled, -1), g_strdup (correction));
+}
+
+static void
+sexy_wordlist_backend_iface_init (SexySpellBackendInterface *iface)
+{
+	iface->list_languages = sexy_wordlist_backend_list_languages;
+	iface->request_dict = sexy_wordlist_backend_request_dict;
+	iface->free_dict = sexy_wordlist_backend_free_dict;
+	iface->describe_dict = sexy_wordlist_backend_describe_dict;
+	iface->check = sexy_wordlist_backend_check;
+	iface->suggest = sexy_wordlist_backend_suggest;
+	iface->add_to_personal = sexy_wordlist_backend_add_to_session;
+	iface->add_to_session = sexy_wordlist_backend_add_to_session;
+	iface->store_replacement = sexy_wordlist_backend_store_replacement;
+}
+
+static void
+sexy_wordlist_backend_set_property (GObject *obj, guint prop_id, const GValue *value, GParamSpec *pspec)
+{
+	SexyWordlistBackend *backend = SEXY_WORDLIST_BACKEND(obj);
+
+	switch (prop_id)
+	{
+		case PROP_CHECK_LATENCY:
+			sexy_wordlist_backend_set_check_latency (backend, g_value_get_uint(value));
+			break;
+		case PROP_SUGGEST_LATENCY:
+			sexy_wordlist_backend_set_suggest_latency (backend, g_value_get_uint(value));
+			break;
+		case PROP_LOAD_LATENCY:
+			sexy_wordlist_backend_set_load_latency (backend, g_value_get_uint(value));
+			break;
+		default:
+			G_OBJECT_WARN_INVALID_PROPERTY_ID (obj, prop_id, pspec);
+			break;
+	}
+}
+
+static void
+sexy_wordlist_backend_get_property (GObject *obj, guint prop_id, GValue *value, GParamSpec *pspec)
+{
+	SexyWordlistBackend *backend = SEXY_WORDLIST_BACKEND(obj);
+
+	switch (prop_id)
+	{
+		case PROP_CHECK_LATENCY:
+			g_value_set_uint (value, sexy_wordlist_backend_get_check_latency (backend));
+			break;
+		case PROP_SUGGEST_LATENCY:
+			g_value_set_uint (value, sexy_wordlist_backend_get_suggest_latency (backend));
+			break;
+		case PROP_LOAD_LATENCY:
+			g_value_set_uint (value, sexy_wordlist_backend_get_load_latency (backend));
+			break;
+		default:
+			G_OBJECT_WARN_INVALID_PROPERTY_ID (obj, prop_id, pspec);
+			break;
+	}
+}
+
+static void
+sexy_wordlist_backend_finalize (GObject *obj)
+{
+	SexyWordlistBackend *backend = SEXY_WORDLIST_BACKEND(obj);
+
+	g_hash_table_destroy (backend->langs);
+	g_mutex_clear (&backend->lock);
+
+	G_OBJECT_CLASS(sexy_wordlist_backend_parent_class)->finalize (obj);
+}
+
+static void
+sexy_wordlist_backend_class_init (SexyWordlistBackendClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS(klass);
+
+	object_class->set_property = sexy_wordlist_backend_set_property;
+	object_class->get_property = sexy_wordlist_backend_get_property;
+	object_class->finalize = sexy_wordlist_backend_finalize;
+
+	/**
+	 * SexyWordlistBackend:check-latency:
+	 *
+	 * Microseconds every lookup takes at least. The time is spent busy
+	 * waiting, like a slow provider would.
+	 *
+	 * Since: 1.2
+	 */
+	g_object_class_install_property (object_class, PROP_CHECK_LATENCY,
+							g_param_spec_uint ("check-latency", "Check Latency",
+										"Microseconds every lookup takes at least",
+										0, G_MAXINT, 0, G_PARAM_READWRITE));
+
+	/**
+	 * SexyWordlistBackend:suggest-latency:
+	 *
+	 * Microseconds finding suggestions for a word takes at least, busy
+	 * waiting.
+	 *
+	 * Since: 1.2
+	 */
+	g_object_class_install_property (object_class, PROP_SUGGEST_LATENCY,
+							g_param_spec_uint ("suggest-latency", "Suggest Latency",
+										"Microseconds finding suggestions takes at least",
+										0, G_MAXINT, 0, G_PARAM_READWRITE));
+
+	/**
+	 * SexyWordlistBackend:load-latency:
+	 *
+	 * Microseconds loading a dictionary takes at least. The loading
+	 * thread sleeps for this long.
+	 *
+	 * Since: 1.2
+	 */
+	g_object_class_install_property (object_class, PROP_LOAD_LATENCY,
+							g_param_spec_uint ("load-latency", "Load Latency",
+										"Microseconds loading a dictionary takes at least",
+										0, G_MAXINT, 0, G_PARAM_READWRITE));
+}
+
+static void
+sexy_wordlist_backend_init (SexyWordlistBackend *backend)
+{
+	g_mutex_init (&backend->lock);
+	backend->langs = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) word_set_unref);
+}
+
+/**
+ * sexy_wordlist_backend_new:
+ *
+ * Creates a new backend without any language. Add some with
+ * sexy_wordlist_backend_load_file() or sexy_wordlist_backend_add_words().
+ *
+ * Returns: (transfer full): a new #SexyWordlistBackend.
+ *
+ * Since: 1.2
+ */
+SexyWordlistBackend *
+sexy_wordlist_backend_new(void)
+{
+	return g_object_new (SEXY_TYPE_WORDLIST_BACKEND, NULL);
+}
+
+/**
+ * sexy_wordlist_backend_load_file:
+ * @backend: A #SexyWordlistBackend.
+ * @lang: The language the words belong to.
+ * @path: A UTF-8 text file with one word per line.
+ * @error: Return location for a #GError, or %NULL.
+ *
+ * Adds the words in @path to @lang. Blank lines are skipped and anything
+ * after a '/' is ignored, so Hunspell .dic files can be loaded as well.
+ *
+ * Dictionaries that are already loaded keep the words they had.
+ *
+ * Returns: %FALSE if @path could not be read, and @error is set.
+ *
+ * Since: 1.2
+ */
+gboolean
+sexy_wordlist_backend_load_file(SexyWordlistBackend *backend, const gchar *lang, const gchar *path,
+                                GError **error)
+{
+	gchar *contents, *line, *next, *end;
+	gsize length;
+	WordSet *set;
+
+	g_return_val_if_fail (SEXY_IS_WORDLIST_BACKEND(backend), FALSE);
+	g_return_val_if_fail (lang != NULL, FALSE);
+	g_return_val_if_fail (path != NULL, FALSE);
+
+	if (!g_file_get_contents (path, &contents, &length, error))
+		return FALSE;
+
+	if (!g_utf8_validate (contents, length, NULL))
+	{
+		g_set_error (error, G_CONVERT_ERROR, G_CONVERT_ERROR_ILLEGAL_SEQUENCE,
+		             _("%s is not valid UTF-8"), path);
+		g_free (contents);
+		return FALSE;
+	}
+
+	g_mutex_lock (&backend->lock);
+	set = get_writable_set (backend, lang);
+
+	for (line = contents; line < contents + length; line = next)
+	{
+		next = strchr (line, '\n');
+		next = next ? next + 1 : contents + length;
+
+		end = line;
+		while (end < next && *end != '/' && !g_ascii_isspace (*end))
+			end++;
+
+		if (end > line)
+			g_hash_table_add (set->words, g_strndup (line, end - line));
+	}
+
+	g_mutex_unlock (&backend->lock);
+	g_free (contents);
+
+	return TRUE;
+}
+
+/**
+ * sexy_wordlist_backend_add_words:
+ * @backend: A #SexyWordlistBackend.
+ * @lang: The language the words belong to.
+ * @words: (array zero-terminated=1): The words to add.
+ *
+ * Adds @words to @lang, creating the language if needed. Dictionaries
+ * that are already loaded keep the words they had.
+ *
+ * Since: 1.2
+ */
+void
+sexy_wordlist_backend_add_words(SexyWordlistBackend *backend, const gchar *lang, const gchar * const *words)
+{
+	WordSet *set;
+	guint i;
+
+	g_return_if_fail (SEXY_IS_WORDLIST_BACKEND(backend));
+	g_return_if_fail (lang != NULL);
+	g_return_if_fail (words != NULL);
+
+	g_mutex_lock (&backend->lock);
+	set = get_writable_set (backend, lang);
+	for (i = 0; words[i] != NULL; i++)
+		g_hash_table_add (set->words, g_strdup (words[i]));
+	g_mutex_unlock (&backend->lock);
+}
+
+/**
+ * sexy_wordlist_backend_get_check_latency:
+ * @backend: A #SexyWordlistBackend.
+ *
+ * Gets the time every lookup takes at least.
+ *
+ * Returns: The latency in microseconds.
+ * Since: 1.2
+ */
+guint
+sexy_wordlist_backend_get_check_latency(SexyWordlistBackend *backend)
+{
+	g_return_val_if_fail (SEXY_IS_WORDLIST_BACKEND(backend), 0);
+
+	return g_atomic_int_get (&backend->check_latency);
+}
+
+/**
+ * sexy_wordlist_backend_set_check_latency:
+ * @backend: A #SexyWordlistBackend.
+ * @usec: The latency in microseconds.
+ *
+ * Makes every lookup take at least @usec microseconds, see
+ * #SexyWordlistBackend:check-latency.
+ *
+ * Since: 1.2
+ */
+void
+sexy_wordlist_backend_set_check_latency(SexyWordlistBackend *backend, guint usec)
+{
+	g_return_if_fail (SEXY_IS_WORDLIST_BACKEND(backend));
+	g_return_if_fail (usec <= G_MAXINT);
+
+	if ((guint) g_atomic_int_get (&backend->check_latency) == usec)
+		return;
+
+	g_atomic_int_set (&backend->check_latency, usec);
+	g_object_notify (G_OBJECT(backend), "check-latency");
+}
+
+/**
+ * sexy_wordlist_backend_get_suggest_latency:
+ * @backend: A #SexyWordlistBackend.
+ *
+ * Gets the time finding suggestions takes at least.
+ *
+ * Returns: The latency in microseconds.
+ * Since: 1.2
+ */
+guint
+sexy_wordlist_backend_get_suggest_latency(SexyWordlistBackend *backend)
+{
+	g_return_val_if_fail (SEXY_IS_WORDLIST_BACKEND(backend), 0);
+
+	return g_atomic_int_get (&backend->suggest_latency);
+}
+
+/**
+ * sexy_wordlist_backend_set_suggest_latency:
+ * @backend: A #SexyWordlistBackend.
+ * @usec: The latency in microseconds.
+ *
+ * Makes finding suggestions for a word take at least @usec microseconds.
+ *
+ * Since: 1.2
+ */
+void
+sexy_wordlist_backend_set_suggest_latency(SexyWordlistBackend *backend, guint usec)
+{
+	g_return_if_fail (SEXY_IS_WORDLIST_BACKEND(backend));
+	g_return_if_fail (usec <= G_MAXINT);
+
+	if ((guint) g_atomic_int_get (&backend->suggest_latency) == usec)
+		return;
+
+	g_atomic_int_set (&backend->suggest_latency, usec);
+	g_object_notify (G_OBJECT(backend), "suggest-latency");
+}
+
+/**
+ * sexy_wordlist_backend_get_load_latency:
+ * @backend: A #SexyWordlistBackend.
+ *
+ * Gets the time loading a dictionary takes at least.
+ *
+ * Returns: The latency in microseconds.
+ * Since: 1.2
+ */
+guint
+sexy_wordlist_backend_get_load_latency(SexyWordlistBackend *backend)
+{
+	g_return_val_if_fail (SEXY_IS_WORDLIST_BACKEND(backend), 0);
+
+	return g_atomic_int_get (&backend->load_latency);
+}
+
+/**
+ * sexy_wordlist_backend_set_load_latency:
+ * @backend: A #SexyWordlistBackend.
+ * @usec: The latency in microseconds.
+ *
+ * Makes loading a dictionary take at least @usec microseconds, which
+ * shows whether it blocks the main loop.
+ *
+ * Since: 1.2
+ */
+void
+sexy_wordlist_backend_set_load_latency(SexyWordlistBackend *backend, guint usec)
+{
+	g_return_if_fail (SEXY_IS_WORDLIST_BACKEND(backend));
+	g_return_if_fail (usec <= G_MAXINT);
+
+	if ((guint) g_atomic_int_get (&backend->load_latency) == usec)
+		return;
+
+	g_atomic_int_set (&backend->load_latency, usec);
+	g_object_notify (G_OBJECT(backend), "load-latency");
+}
@@ -0,0 +1,41 @@
+/*
+ * @file libsexy/sexy-wordlist-backend.h Dictionaries from word lists
+ *
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+#pragma once
+
+#include "sexy-spell-backend.h"
+
+G_BEGIN_DECLS
+
+#define SEXY_TYPE_WORDLIST_BACKEND (sexy_wordlist_backend_get_type())
+G_DECLARE_FINAL_TYPE(SexyWordlistBackend, sexy_wordlist_backend, SEXY, WORDLIST_BACKEND, GObject)
+
+SexyWordlistBackend* sexy_wordlist_backend_new(void);
+gboolean sexy_wordlist_backend_load_file(SexyWordlistBackend *backend, const gchar *lang, const gchar *path,
+                                         GError **error);
+void sexy_wordlist_backend_add_words(SexyWordlistBackend *backend, const gchar *lang, const gchar * const *words);
+guint sexy_wordlist_backend_get_check_latency(SexyWordlistBackend *backend);
+void sexy_wordlist_backend_set_check_latency(SexyWordlistBackend *backend, guint usec);
+guint sexy_wordlist_backend_get_suggest_latency(SexyWordlistBackend *backend);
+void sexy_wordlist_backend_set_suggest_latency(SexyWordlistBackend *backend, guint usec);
+guint sexy_wordlist_backend_get_load_latency(SexyWordlistBackend *backend);
+void sexy_wordlist_backend_set_load_latency(SexyWordlistBackend *backend, guint usec);
+
+G_END_DECLS
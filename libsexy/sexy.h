@@ -21,4 +21,7 @@
 
 #pragma once
 
+#include <libsexy3/sexy-spell-backend.h>
+#include <libsexy3/sexy-spell-checker.h>
 #include <libsexy3/sexy-spell-entry.h>
+#include <libsexy3/sexy-wordlist-backend.h>
@@ -0,0 +1,124 @@
+/*
+ * @file tests/test-tokenizer.c Word splitting
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+/*
+ * Splits fixed strings into words, once with the byte classifier and
+ * once with Pango only, and checks that both find the same words.
+ */
+
+#include <string.h>
+
+#include <glib.h>
+
+#include "sexy-tokenizer.h"
+
+typedef struct
+{
+	const gchar *text;
+	/* The words, separated by '|' */
+	const gchar *words;
+} Sample;
+
+static const Sample samples[] = {
+	{ "hello world", "hello|world" },
+	{ "foo;bar", "foo|bar" },
+	{ "hello,world", "hello|world" },
+	{ "don't stop", "don't|stop" },
+	{ "e.g. this", "e.g|this" },
+	{ "a.b a:b", "a.b|a:b" },
+	{ "3;4 1,000.5", "3;4|1,000.5" },
+	{ "it's 12:30", "it's|12|30" },
+	{ "foo_bar", "foo_bar" },
+	{ "-- (quoted) text!", "quoted|text" },
+	{ "the naïve café", "the|naïve|café" },
+	{ "", "" }
+};
+
+static gchar *
+join_words (const gchar *text, const SexyWordList *words)
+{
+	GString *joined = g_string_new (NULL);
+	guint i;
+
+	for (i = 0; i < words->len; i++)
+	{
+		if (i > 0)
+			g_string_append_c (joined, '|');
+		g_string_append_len (joined, text + words->starts[i], words->ends[i] - words->starts[i]);
+	}
+
+	return g_string_free (joined, FALSE);
+}
+
+static void
+test_same_words (void)
+{
+	SexyWordList *words = sexy_word_list_new ();
+	guint i;
+
+	for (i = 0; i < G_N_ELEMENTS (samples); i++)
+	{
+		const gchar *text = samples[i].text;
+		gint len = (gint) strlen (text);
+		gchar *ascii, *pango;
+
+		sexy_word_list_clear (words);
+		sexy_tokenize (text, len, 0, len, words);
+		ascii = join_words (text, words);
+
+		sexy_word_list_clear (words);
+		sexy_tokenize_pango (text, len, 0, len, words);
+		pango = join_words (text, words);
+
+		g_assert_cmpstr (ascii, ==, samples[i].words);
+		g_assert_cmpstr (pango, ==, ascii);
+
+		g_free (ascii);
+		g_free (pango);
+	}
+
+	sexy_word_list_free (words);
+}
+
+/* Words starting at or after @end are left out, the one across it is not */
+static void
+test_end (void)
+{
+	const gchar *text = "one two three";
+	SexyWordList *words = sexy_word_list_new ();
+	gchar *joined;
+
+	sexy_tokenize (text, (gint) strlen (text), 0, 5, words);
+	joined = join_words (text, words);
+	g_assert_cmpstr (joined, ==, "one|two");
+	g_free (joined);
+
+	sexy_word_list_free (words);
+}
+
+int
+main (int argc, char **argv)
+{
+	g_test_init (&argc, &argv, NULL);
+
+	g_test_add_func ("/tokenizer/same-words", test_same_words);
+	g_test_add_func ("/tokenizer/end", test_end);
+
+	return g_test_run ();
+}
@@ -0,0 +1,165 @@
+/*
+ * @file tests/test-wordlist-backend.c Word list backend
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA  02111-1307, USA.
+ */
+
+/*
+ * Checks words against a small word list through the backend interface:
+ * which capitalizations of a word are accepted, and what is suggested.
+ */
+
+#include <glib.h>
+
+#include "sexy-wordlist-backend.h"
+
+#define LANG "xx"
+
+static const gchar * const words[] = {
+	"word", "Paris", "spell", "spelt", "smell", "shell", "spill", "apple", NULL
+};
+
+typedef struct
+{
+	SexySpellBackend *backend;
+	SexySpellBackendInterface *iface;
+	gpointer dict;
+} Fixture;
+
+static void
+fixture_set_up (Fixture *fixture, gconstpointer data)
+{
+	SexyWordlistBackend *backend = sexy_wordlist_backend_new ();
+
+	sexy_wordlist_backend_add_words (backend, LANG, words);
+	fixture->backend = SEXY_SPELL_BACKEND(backend);
+	fixture->iface = SEXY_SPELL_BACKEND_GET_IFACE(backend);
+	fixture->dict = fixture->iface->request_dict (fixture->backend, LANG);
+	g_assert_nonnull (fixture->dict);
+}
+
+static void
+fixture_tear_down (Fixture *fixture, gconstpointer data)
+{
+	fixture->iface->free_dict (fixture->backend, fixture->dict);
+	g_object_unref (fixture->backend);
+}
+
+static gboolean
+check (Fixture *fixture, const gchar *word)
+{
+	return fixture->iface->check (fixture->backend, fixture->dict, word, -1);
+}
+
+static gchar *
+suggest (Fixture *fixture, const gchar *word)
+{
+	gchar **suggestions = fixture->iface->suggest (fixture->backend, fixture->dict, word, -1);
+	gchar *joined = g_strjoinv ("|", suggestions);
+
+	g_strfreev (suggestions);
+	return joined;
+}
+
+/* "Word" and "WORD" are right if "word" is, but not "wOrd" */
+static void
+test_capitalization (Fixture *fixture, gconstpointer data)
+{
+	g_assert_true (check (fixture, "word"));
+	g_assert_true (check (fixture, "Word"));
+	g_assert_true (check (fixture, "WORD"));
+	g_assert_false (check (fixture, "wOrd"));
+	g_assert_false (check (fixture, "WOrd"));
+
+	/* Capitals of the word list are kept */
+	g_assert_true (check (fixture, "Paris"));
+	g_assert_false (check (fixture, "paris"));
+
+	g_assert_false (check (fixture, "wrod"));
+	g_assert_false (check (fixture, ""));
+}
+
+static void
+test_length (Fixture *fixture, gconstpointer data)
+{
+	g_assert_true (fixture->iface->check (fixture->backend, fixture->dict, "words", 4));
+	g_assert_false (fixture->iface->check (fixture->backend, fixture->dict, "wordy", 5));
+}
+
+static void
+test_session (Fixture *fixture, gconstpointer data)
+{
+	g_assert_false (check (fixture, "libsexy"));
+	fixture->iface->add_to_session (fixture->backend, fixture->dict, "libsexy");
+	g_assert_true (check (fixture, "libsexy"));
+	g_assert_true (check (fixture, "Libsexy"));
+}
+
+/* Words at most two edits away, nearest first, then in byte order */
+static void
+test_suggest (Fixture *fixture, gconstpointer data)
+{
+	gchar *suggestions;
+
+	suggestions = suggest (fixture, "speel");
+	g_assert_cmpstr (suggestions, ==, "spell|shell|smell|spelt|spill");
+	g_free (suggestions);
+
+	/* Suggestions are made for the word in lower case */
+	suggestions = suggest (fixture, "APPEL");
+	g_assert_cmpstr (suggestions, ==, "apple");
+	g_free (suggestions);
+
+	suggestions = suggest (fixture, "xyzzy");
+	g_assert_cmpstr (suggestions, ==, "");
+	g_free (suggestions);
+}
+
+/* A stored replacement comes first, and only once */
+static void
+test_replacement (Fixture *fixture, gconstpointer data)
+{
+	gchar *suggestions;
+
+	fixture->iface->store_replacement (fixture->backend, fixture->dict, "Speel", "spelt");
+	suggestions = suggest (fixture, "speel");
+	g_assert_cmpstr (suggestions, ==, "spelt|spell|shell|smell|spill");
+	g_free (suggestions);
+
+	fixture->iface->store_replacement (fixture->backend, fixture->dict, "speel", "speed");
+	suggestions = suggest (fixture, "speel");
+	g_assert_cmpstr (suggestions, ==, "speed|spell|shell|smell|spelt|spill");
+	g_free (suggestions);
+}
+
+int
+main (int argc, char **argv)
+{
+	g_test_init (&argc, &argv, NULL);
+
+	g_test_add ("/wordlist-backend/capitalization", Fixture, NULL,
+	            fixture_set_up, test_capitalization, fixture_tear_down);
+	g_test_add ("/wordlist-backend/length", Fixture, NULL,
+	            fixture_set_up, test_length, fixture_tear_down);
+	g_test_add ("/wordlist-backend/session", Fixture, NULL,
+	            fixture_set_up, test_session, fixture_tear_down);
+	g_test_add ("/wordlist-backend/suggest", Fixture, NULL,
+	            fixture_set_up, test_suggest, fixture_tear_down);
+	g_test_add ("/wordlist-backend/replacement", Fixture, NULL,
+	            fixture_set_up, test_replacement, fixture_tear_down);
+
+	return g_test_run ();
+}